@@ -0,0 +1,312 @@
+#include "adjacency.h"
+#include "parallel.h"
+#include "tombstone.h"
+
+namespace flux {
+
+Adjacency::Adjacency() :
+_halfmesh(nullptr)
+{  }
+
+void
+Adjacency::build(HalfEdgeMesh<Triangle>& halfmesh, int num_threads) {
+    /**
+     * Numbers the vertices and faces of halfmesh and fills both tables. Each
+     * thread gathers the rows of a contiguous range of vertices, and the
+     * per-thread rows are then concatenated in vertex order
+     */
+    clear();
+    _halfmesh = &halfmesh;
+
+    for (auto& v : halfmesh.vertices()) {
+        if (!is_dead(v.get())) add_vertex(v.get());
+    }
+    for (auto& f : halfmesh.faces()) {
+        if (!is_dead(f.get())) add_face(f.get());
+    }
+
+    int num_vertices = _vertices.size();
+    num_threads = std::max(1, std::min(num_threads, num_vertices));
+    _vertex_offset.resize(num_vertices);
+    _vertex_count.resize(num_vertices);
+    _face_offset.resize(num_vertices);
+    _face_count.resize(num_vertices);
+
+    parallel_for(_faces.size(), num_threads, [this](int, int begin, int end) {
+        for (int f = begin; f < end; ++f) {
+            update_triangle(f);
+        }
+    });
+
+    // Unordered face rows from the corners, so index(face) works while the
+    // ordered rows are gathered
+    int num_corners = _triangles.size();
+    for (int c = 0; c < num_corners; ++c) _face_count[_triangles[c]]++;
+    for (int v = 0, offset = 0; v < num_vertices; ++v) {
+        _face_offset[v] = offset;
+        offset += _face_count[v];
+        _face_count[v] = 0;
+    }
+    _incident_faces.resize(num_corners);
+    for (int c = 0; c < num_corners; ++c) {
+        int v = _triangles[c];
+        _incident_faces[_face_offset[v] + _face_count[v]++] = c / 3;
+    }
+
+    std::vector<std::vector<int>> local_neighbours(num_threads);
+    std::vector<std::vector<int>> local_faces(num_threads);
+    std::vector<int> local_face_offset(num_vertices);
+
+    parallel_for(num_vertices, num_threads, [&](int thread, int begin, int end) {
+        std::vector<HalfVertex*> vertex_onering;
+        std::vector<HalfFace*> face_onering;
+        std::vector<int>& neighbours = local_neighbours[thread];
+        std::vector<int>& faces = local_faces[thread];
+
+        for (int v = begin; v < end; ++v) {
+            _halfmesh->get_onering(_vertices[v], vertex_onering);
+            _halfmesh->get_onering(_vertices[v], face_onering);
+
+            // Offsets are local to the thread until the rows are concatenated
+            _vertex_offset[v] = neighbours.size();
+            _vertex_count[v] = vertex_onering.size();
+            for (HalfVertex *neighbour : vertex_onering) {
+                neighbours.push_back(index(neighbour));
+            }
+
+            local_face_offset[v] = faces.size();
+            for (HalfFace *face : face_onering) {
+                faces.push_back(index(face));
+            }
+        }
+    });
+
+    // Turning local offsets into global ones
+    int chunk = (num_vertices + num_threads - 1) / num_threads;
+    std::vector<int> neighbour_base(num_threads + 1, 0);
+    std::vector<int> face_base(num_threads + 1, 0);
+    for (int t = 0; t < num_threads; ++t) {
+        neighbour_base[t + 1] = neighbour_base[t] + local_neighbours[t].size();
+        face_base[t + 1] = face_base[t] + local_faces[t].size();
+    }
+    _neighbours.resize(neighbour_base[num_threads]);
+    _incident_faces.resize(face_base[num_threads]);
+
+    parallel_for(num_threads, num_threads, [&](int, int begin, int end) {
+        for (int t = begin; t < end; ++t) {
+            std::copy(local_neighbours[t].begin(), local_neighbours[t].end(),
+                _neighbours.begin() + neighbour_base[t]);
+            std::copy(local_faces[t].begin(), local_faces[t].end(),
+                _incident_faces.begin() + face_base[t]);
+
+            int last = std::min(num_vertices, (t + 1) * chunk);
+            for (int v = t * chunk; v < last; ++v) {
+                _vertex_offset[v] += neighbour_base[t];
+                _face_offset[v] = local_face_offset[v] + face_base[t];
+            }
+        }
+    });
+}
+
+void
+Adjacency::update(HalfVertex *vertex) {
+    /**
+     * Re-derives both rows of vertex from the halfedge connectivity. Vertices
+     * and faces that are not numbered yet (created by a split) get new ids.
+     * The rows are appended, leaving the old ones as unused space until the
+     * next build
+     */
+    flux_assert(is_built());
+    int v = index(vertex);
+    if (v < 0) v = add_vertex(vertex);
+
+    _halfmesh->get_onering(vertex, _vertex_onering);
+    _halfmesh->get_onering(vertex, _face_onering);
+
+    // Faces are looked up while the old row of vertex is still in place
+    _face_ids.clear();
+    for (HalfFace *face : _face_onering) {
+        int f = index(face);
+        _face_ids.push_back((f < 0) ? add_face(face) : f);
+    }
+
+    _vertex_offset[v] = _neighbours.size();
+    _vertex_count[v] = _vertex_onering.size();
+    for (HalfVertex *neighbour : _vertex_onering) {
+        int n = index(neighbour);
+        _neighbours.push_back((n < 0) ? add_vertex(neighbour) : n);
+    }
+
+    _face_offset[v] = _incident_faces.size();
+    _face_count[v] = _face_ids.size();
+    for (int f : _face_ids) {
+        _incident_faces.push_back(f);
+
+        // Corners (or the first corner) of the face may have changed as well
+        update_triangle(f);
+    }
+}
+
+void
+Adjacency::remove(HalfVertex *vertex) {
+    /**
+     * Forgets vertex. Its id stays reserved with empty rows
+     */
+    int v = index(vertex);
+    if (v < 0) return;
+
+    _vertices[v] = nullptr;
+    _vertex_count[v] = 0;
+    _face_count[v] = 0;
+}
+
+void
+Adjacency::remove(HalfFace *face) {
+    /**
+     * Forgets face. Its id stays reserved. Must be called before the rows of
+     * its old corners are updated
+     */
+    int f = index(face);
+    if (f < 0) return;
+
+    _faces[f] = nullptr;
+    _triangles[3 * f] = _triangles[3 * f + 1] = _triangles[3 * f + 2] = -1;
+}
+
+void
+Adjacency::clear() {
+    /**
+     * Drops all tables
+     */
+    _halfmesh = nullptr;
+    _vertices.clear();
+    _faces.clear();
+    _vertex_offset.clear();
+    _vertex_count.clear();
+    _neighbours.clear();
+    _face_offset.clear();
+    _face_count.clear();
+    _incident_faces.clear();
+    _triangles.clear();
+}
+
+int
+Adjacency::color(std::vector<int>& offsets, std::vector<int>& vertices) const {
+    /**
+     * Greedy colouring of the vertex graph in id order: each vertex gets the
+     * smallest colour none of its neighbours has. Vertices of colour c are
+     * vertices[offsets[c] .. offsets[c + 1]), no two of them are neighbours.
+     * Removed vertices get no colour
+     *
+     * RETURNS: number of colours
+     */
+    int num_vertices = nb_vertices();
+    std::vector<int> colors(num_vertices, -1);
+    std::vector<int> used;  // used[c] == v when a neighbour of v has colour c
+    int num_colors = 0;
+
+    for (int v = 0; v < num_vertices; ++v) {
+        if (!_vertices[v]) continue;
+
+        const int *onering = neighbours(v);
+        for (int i = 0; i < valence(v); ++i) {
+            int c = colors[onering[i]];
+            if (c >= 0) used[c] = v;
+        }
+
+        int c = 0;
+        while (c < num_colors && used[c] == v) c++;
+        if (c == num_colors) {
+            num_colors++;
+            used.push_back(-1);
+        }
+        colors[v] = c;
+    }
+
+    // Counting sort of the vertices by colour
+    offsets.assign(num_colors + 1, 0);
+    for (int v = 0; v < num_vertices; ++v) {
+        if (colors[v] >= 0) offsets[colors[v] + 1]++;
+    }
+    for (int c = 0; c < num_colors; ++c) offsets[c + 1] += offsets[c];
+
+    vertices.resize(offsets[num_colors]);
+    std::vector<int> next(offsets.begin(), offsets.end() - 1);
+    for (int v = 0; v < num_vertices; ++v) {
+        if (colors[v] >= 0) vertices[next[colors[v]]++] = v;
+    }
+    return num_colors;
+}
+
+int
+Adjacency::index(const HalfVertex *vertex) const {
+    /**
+     * Returns id of vertex or -1 if it is not numbered. The id read from
+     * vertex->index is only trusted if it maps back to vertex, so vertices
+     * that were created, recycled or killed since are not numbered
+     */
+    int v = (vertex->index >= 0) ? vertex->index : -2 - vertex->index;
+    if (v < 0 || v >= (int) _vertices.size() || _vertices[v] != vertex) return -1;
+    return v;
+}
+
+int
+Adjacency::index(const HalfFace *face) const {
+    /**
+     * Returns id of face or -1 if it is not numbered. A split, collapse or
+     * flip moves at most one corner of a face before its corners are updated,
+     * so the face is still in the row of one of its other corners
+     */
+    const HalfEdge *edge = face->edge;
+    for (int j = 0; j < 3; ++j, edge = edge->next) {
+        int v = index(edge->vertex);
+        if (v < 0) continue;
+
+        const int *faces = incident_faces(v);
+        for (int i = 0; i < nb_incident_faces(v); ++i) {
+            if (_faces[faces[i]] == face) return faces[i];
+        }
+    }
+    return -1;
+}
+
+int
+Adjacency::add_vertex(HalfVertex *vertex) {
+    /**
+     * Numbers vertex with empty rows
+     */
+    int v = _vertices.size();
+    _vertices.push_back(vertex);
+    vertex->index = (vertex->index <= -1) ? -2 - v : v;
+    _vertex_offset.push_back(0);
+    _vertex_count.push_back(0);
+    _face_offset.push_back(0);
+    _face_count.push_back(0);
+    return v;
+}
+
+int
+Adjacency::add_face(HalfFace *face) {
+    /**
+     * Numbers face
+     */
+    int f = _faces.size();
+    _faces.push_back(face);
+    _triangles.resize(_triangles.size() + 3, -1);
+    return f;
+}
+
+void
+Adjacency::update_triangle(int f) {
+    /**
+     * Re-derives the corner ids of face f, starting at face->edge. Corners that
+     * are not numbered yet are left as -1 until their own update
+     */
+    HalfEdge *edge = _faces[f]->edge;
+    for (int j = 0; j < 3; ++j) {
+        _triangles[3 * f + j] = index(edge->vertex);
+        edge = edge->next;
+    }
+}
+
+} // flux
@@ -0,0 +1,83 @@
+#ifndef FLUX_REMESHER3D_ADJACENCY_H
+#define FLUX_REMESHER3D_ADJACENCY_H
+
+#include "halfedges.h"
+#include "element.h"
+#include <vector>
+
+namespace flux {
+
+/**
+ * One-ring adjacency of a HalfEdgeMesh in compressed-sparse-row form.
+ *
+ * Every vertex and face gets an integer id. Row v of the vertex table holds
+ * the ids of the neighbours of vertex v, row v of the face table the ids of
+ * its incident faces, both in the order returned by get_onering. Each face
+ * also keeps the ids of its three vertices, starting at face->edge. Rows that
+ * are patched after a split or collapse are rewritten at the end of the
+ * arrays, so ids of untouched elements never change between builds.
+ *
+ * There are no hash tables. A numbered vertex holds its id in
+ * HalfVertex::index, as v inside the mesh and -2 - v on the boundary so the
+ * index <= -1 boundary test still holds. HalfFace has no room for an id, so
+ * a face is found in the incident face rows of its corners.
+ */
+class Adjacency {
+public:
+
+Adjacency();
+
+void build(HalfEdgeMesh<Triangle>& halfmesh, int num_threads);
+void update(HalfVertex *vertex);
+void remove(HalfVertex *vertex);
+void remove(HalfFace *face);
+void clear();
+int color(std::vector<int>& offsets, std::vector<int>& vertices) const;
+bool is_built() const { return _halfmesh != nullptr; }
+
+/* Vertices */
+int nb_vertices() const { return _vertices.size(); }
+HalfVertex* vertex(int v) const { return _vertices[v]; }
+int index(const HalfVertex *vertex) const;
+
+/* Faces */
+int nb_faces() const { return _faces.size(); }
+HalfFace* face(int f) const { return _faces[f]; }
+int index(const HalfFace *face) const;
+const int* triangle(int f) const { return _triangles.data() + 3 * f; }
+
+/* Rows */
+int valence(int v) const { return _vertex_count[v]; }
+const int* neighbours(int v) const { return _neighbours.data() + _vertex_offset[v]; }
+int nb_incident_faces(int v) const { return _face_count[v]; }
+const int* incident_faces(int v) const { return _incident_faces.data() + _face_offset[v]; }
+
+private:
+HalfEdgeMesh<Triangle>* _halfmesh;
+
+std::vector<HalfVertex*> _vertices;
+std::vector<HalfFace*> _faces;
+
+std::vector<int> _vertex_offset;
+std::vector<int> _vertex_count;
+std::vector<int> _neighbours;
+
+std::vector<int> _face_offset;
+std::vector<int> _face_count;
+std::vector<int> _incident_faces;
+
+std::vector<int> _triangles;
+
+// Scratch space for update() so patching does not allocate
+std::vector<HalfVertex*> _vertex_onering;
+std::vector<HalfFace*> _face_onering;
+std::vector<int> _face_ids;
+
+int add_vertex(HalfVertex *vertex);
+int add_face(HalfFace *face);
+void update_triangle(int f);
+};
+
+} // flux
+
+#endif
@@ -0,0 +1,130 @@
+#include "batch.h"
+#include "tombstone.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace flux {
+
+/**
+ * Tasks [begin, end) a worker has yet to run. The owner takes from the
+ * front, thieves take the back half.
+ */
+struct TaskRange {
+    std::mutex mutex;
+    int begin;
+    int end;
+};
+
+static bool
+pop_task(TaskRange& range, int& task) {
+    std::lock_guard<std::mutex> lock(range.mutex);
+    if (range.begin >= range.end) return false;
+    task = range.begin++;
+    return true;
+}
+
+static bool
+steal_tasks(std::vector<std::unique_ptr<TaskRange>>& ranges, int thief, int& task) {
+    /**
+     * Moves the back half of the first non-empty range after the thief's
+     * into the thief's (empty) range and takes its first task
+     *
+     * RETURNS: false once every range is empty, i.e. the batch is done
+     */
+    int num_ranges = ranges.size();
+    for (int i = 1; i < num_ranges; ++i) {
+        TaskRange& victim = *ranges[(thief + i) % num_ranges];
+        int begin, end;
+        {
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.begin >= victim.end) continue;
+            begin = victim.begin + (victim.end - victim.begin) / 2;
+            end = victim.end;
+            victim.end = begin;
+        }
+
+        TaskRange& own = *ranges[thief];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        task = begin;
+        own.begin = begin + 1;
+        own.end = end;
+        return true;
+    }
+    return false;
+}
+
+static void
+run_task(const RemeshTask& task, RemesherScratch& scratch, RemeshResult& result) {
+    auto start = std::chrono::steady_clock::now();
+
+    // Each mesh is too small to split further, so its remesher runs alone
+    Remesher3d remesh(*task.halfmesh, *task.sizing_field);
+    remesh.set_verbose(false);
+    remesh.swap_scratch(scratch);
+    result.reports = remesh.incremental_relaxation(task.num_iterations);
+    remesh.swap_scratch(scratch);
+
+    result.num_vertices = 0;
+    result.num_faces = 0;
+    for (auto& v : task.halfmesh->vertices()) {
+        if (!is_dead(v.get())) result.num_vertices++;
+    }
+    for (auto& f : task.halfmesh->faces()) {
+        if (!is_dead(f.get())) result.num_faces++;
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    result.seconds = elapsed.count();
+}
+
+std::vector<RemeshResult>
+remesh_batch(const std::vector<RemeshTask>& tasks, int num_threads) {
+    /**
+     * Remeshes every task, each with its own single-threaded Remesher3d, on
+     * num_threads workers. Workers start with equal contiguous shares of the
+     * tasks and, once theirs runs out, steal half of what another worker has
+     * left, so a few expensive meshes do not hold up the batch. Each worker
+     * keeps one RemesherScratch for all the meshes it runs
+     *
+     * RETURNS: one result per task, in task order
+     */
+    int num_tasks = tasks.size();
+    std::vector<RemeshResult> results(num_tasks);
+    if (num_tasks == 0) return results;
+    num_threads = std::max(1, std::min(num_threads, num_tasks));
+
+    std::vector<std::unique_ptr<TaskRange>> ranges;
+    for (int t = 0; t < num_threads; ++t) {
+        ranges.emplace_back(new TaskRange);
+        ranges[t]->begin = (long long) num_tasks * t / num_threads;
+        ranges[t]->end = (long long) num_tasks * (t + 1) / num_threads;
+    }
+
+    auto work = [&](int thread) {
+        RemesherScratch scratch;
+        int task;
+        while (pop_task(*ranges[thread], task) || steal_tasks(ranges, thread, task)) {
+            run_task(tasks[task], scratch, results[task]);
+            results[task].thread = thread;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(num_threads - 1);
+    for (int t = 1; t < num_threads; ++t) {
+        workers.emplace_back(work, t);
+    }
+
+    // Calling thread is worker 0
+    work(0);
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return results;
+}
+
+} // flux
@@ -0,0 +1,37 @@
+#ifndef FLUX_REMESHER3D_BATCH_H
+#define FLUX_REMESHER3D_BATCH_H
+
+#include "remesher3d.h"
+#include <vector>
+
+namespace flux {
+
+/**
+ * One mesh of a batch: remeshed in place with up to num_iterations
+ * incremental_relaxation passes towards sizing_field. Tasks may share a
+ * sizing field, never a mesh. A shared field is called by several workers at
+ * once, so it must be safe to call concurrently (see BatchSizingField).
+ */
+struct RemeshTask {
+    HalfEdgeMesh<Triangle> *halfmesh;
+    SizingField<3> *sizing_field;
+    int num_iterations;
+};
+
+/**
+ * Outcome of one RemeshTask: the per-pass reports, the size of the mesh it
+ * left behind, the worker that ran it and how long that took.
+ */
+struct RemeshResult {
+    std::vector<IterationReport> reports;
+    int num_vertices;
+    int num_faces;
+    int thread;
+    double seconds;
+};
+
+std::vector<RemeshResult> remesh_batch(const std::vector<RemeshTask>& tasks, int num_threads);
+
+} // flux
+
+#endif
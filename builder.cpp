@@ -0,0 +1,262 @@
+#include "builder.h"
+#include "parallel.h"
+#include "tombstone.h"
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+namespace flux {
+
+namespace {
+
+typedef std::pair<unsigned long long, int> EdgeKey;
+
+void
+sort_keys(std::vector<EdgeKey>& keys, int num_threads) {
+    /**
+     * Sorts one run per thread, then merges neighbouring runs pairwise (each
+     * merge on its own thread) until one run is left
+     */
+    int num_keys = keys.size();
+    if (num_keys == 0) return;
+
+    int num_runs = std::max(1, std::min(num_threads, num_keys));
+    int width = (num_keys + num_runs - 1) / num_runs;
+    parallel_for(num_runs, num_threads, [&](int, int begin, int end) {
+        for (int run = begin; run < end; ++run) {
+            int first = std::min(num_keys, run * width);
+            int last = std::min(num_keys, first + width);
+            std::sort(keys.begin() + first, keys.begin() + last);
+        }
+    });
+
+    std::vector<EdgeKey> merged(num_keys);
+    for (; width < num_keys; width *= 2) {
+        int num_merges = (num_keys + 2 * width - 1) / (2 * width);
+        parallel_for(num_merges, num_threads, [&](int, int begin, int end) {
+            for (int m = begin; m < end; ++m) {
+                int first = 2 * m * width;
+                int middle = std::min(num_keys, first + width);
+                int last = std::min(num_keys, first + 2 * width);
+                std::merge(keys.begin() + first, keys.begin() + middle, keys.begin() + middle,
+                    keys.begin() + last, merged.begin() + first);
+            }
+        });
+        keys.swap(merged);
+    }
+}
+
+} // namespace
+
+bool
+build_halfmesh(
+    const double *points,
+    int num_vertices,
+    const int *triangles,
+    int num_triangles,
+    HalfEdgeMesh<Triangle>& halfmesh,
+    int num_threads
+) {
+    /**
+     * Replaces the contents of halfmesh with the triangles (three vertex ids
+     * each) over points (xyz triples)
+     *
+     * RETURNS: false if the triangles do not form a manifold surface
+     */
+    halfmesh.vertices().clear();
+    halfmesh.edges().clear();
+    halfmesh.faces().clear();
+
+    int num_halfedges = 3 * num_triangles;
+    int num_runs = std::max(1, std::min(num_threads, num_halfedges));
+    std::vector<char> valid(num_runs, 1);
+
+    // Keys of every corner, (min, max) in the high and low 32 bits
+    std::vector<EdgeKey> keys(num_halfedges);
+    parallel_for(num_halfedges, num_threads, [&](int thread, int begin, int end) {
+        for (int h = begin; h < end; ++h) {
+            int t = h / 3;
+            unsigned long long a = triangles[h];
+            unsigned long long b = triangles[3 * t + (h + 1) % 3];
+            if (a == b || a >= (unsigned long long) num_vertices
+                || b >= (unsigned long long) num_vertices) {
+                valid[thread] = 0;
+            }
+            keys[h] = EdgeKey((std::min(a, b) << 32) | std::max(a, b), h);
+        }
+    });
+    if (std::count(valid.begin(), valid.end(), 0)) return false;
+
+    sort_keys(keys, num_threads);
+
+    // Pairing twins, every thread takes the runs of equal keys starting in its range
+    std::vector<int> twins(num_halfedges, -1);
+    std::vector<std::vector<int>> boundary_runs(num_runs);
+    parallel_for(num_halfedges, num_runs, [&](int thread, int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            if (i > 0 && keys[i].first == keys[i - 1].first) continue;
+
+            int count = 1;
+            while (i + count < num_halfedges && keys[i + count].first == keys[i].first) count++;
+            if (count == 1) {
+                boundary_runs[thread].push_back(keys[i].second);
+                continue;
+            }
+
+            int h = keys[i].second, g = keys[i + 1].second;
+            if (count > 2 || triangles[h] == triangles[g]) {
+                valid[thread] = 0;
+                continue;
+            }
+            twins[h] = g;
+            twins[g] = h;
+        }
+    });
+    if (std::count(valid.begin(), valid.end(), 0)) return false;
+
+    // Boundary halfedges come after the face halfedges, in key order
+    std::vector<int> boundary_edges;
+    for (auto& run : boundary_runs) {
+        boundary_edges.insert(boundary_edges.end(), run.begin(), run.end());
+    }
+    int num_boundary = boundary_edges.size();
+
+    std::vector<int> leaving(num_vertices, -1), entering(num_vertices, -1);
+    for (int j = 0; j < num_boundary; ++j) {
+        int h = boundary_edges[j];
+        int tail = triangles[h], head = triangles[3 * (h / 3) + (h + 1) % 3];
+        if (leaving[head] >= 0 || entering[tail] >= 0) return false;
+
+        // The boundary halfedge runs from head to tail
+        twins[h] = num_halfedges + j;
+        leaving[head] = num_halfedges + j;
+        entering[tail] = num_halfedges + j;
+    }
+
+    // Containers are sized once, every element is still its own allocation
+    halfmesh.vertices().reserve(num_vertices);
+    halfmesh.edges().reserve(num_halfedges + num_boundary);
+    halfmesh.faces().reserve(num_triangles);
+    for (int v = 0; v < num_vertices; ++v) halfmesh.create_vertex(3, points + 3 * v);
+    for (int h = 0; h < num_halfedges + num_boundary; ++h) halfmesh.create_edge();
+    for (int t = 0; t < num_triangles; ++t) halfmesh.create_face();
+
+    auto vertex = [&](int v) { return halfmesh.vertices()[v].get(); };
+    auto edge = [&](int h) { return halfmesh.edges()[h].get(); };
+
+    parallel_for(num_vertices, num_threads, [&](int, int begin, int end) {
+        for (int v = begin; v < end; ++v) {
+            vertex(v)->index = (leaving[v] >= 0) ? -1 : v;
+        }
+    });
+    parallel_for(num_triangles, num_threads, [&](int, int begin, int end) {
+        for (int t = begin; t < end; ++t) {
+            HalfFace *face = halfmesh.faces()[t].get();
+            face->edge = edge(3 * t);
+            for (int i = 0; i < 3; ++i) {
+                HalfEdge *halfedge = edge(3 * t + i);
+                halfedge->vertex = vertex(triangles[3 * t + i]);
+                halfedge->twin = edge(twins[3 * t + i]);
+                halfedge->next = edge(3 * t + (i + 1) % 3);
+                halfedge->prev = edge(3 * t + (i + 2) % 3);
+                halfedge->face = face;
+            }
+        }
+    });
+    parallel_for(num_boundary, num_threads, [&](int, int begin, int end) {
+        for (int j = begin; j < end; ++j) {
+            int h = boundary_edges[j];
+            int tail = triangles[h], head = triangles[3 * (h / 3) + (h + 1) % 3];
+
+            HalfEdge *halfedge = edge(num_halfedges + j);
+            halfedge->vertex = vertex(head);
+            halfedge->twin = edge(h);
+            halfedge->next = edge(leaving[tail]);
+            halfedge->prev = edge(entering[head]);
+            halfedge->face = nullptr;
+        }
+    });
+
+    // Every vertex starts at its lowest corner
+    for (int h = num_halfedges - 1; h >= 0; --h) {
+        vertex(triangles[h])->edge = edge(h);
+    }
+    return true;
+}
+
+bool
+build_halfmesh(const Mesh<Triangle>& mesh, HalfEdgeMesh<Triangle>& halfmesh, int num_threads) {
+    /**
+     * build_halfmesh() over the vertices and triangles of mesh
+     */
+    int num_vertices = mesh.vertices().nb();
+    int num_triangles = mesh.nb();
+
+    std::vector<double> points(3 * num_vertices, 0.0);
+    std::vector<int> triangles(3 * num_triangles);
+    for (int v = 0; v < num_vertices; ++v) {
+        for (int d = 0; d < std::min(3, mesh.vertices().dim()); ++d) {
+            points[3 * v + d] = mesh.vertices()[v][d];
+        }
+    }
+    for (int t = 0; t < num_triangles; ++t) {
+        for (int i = 0; i < 3; ++i) triangles[3 * t + i] = mesh[t][i];
+    }
+
+    return build_halfmesh(points.data(), num_vertices, triangles.data(), num_triangles,
+        halfmesh, num_threads);
+}
+
+void
+extract_halfmesh(
+    const HalfEdgeMesh<Triangle>& halfmesh,
+    std::vector<double>& points,
+    std::vector<int>& triangles,
+    int num_threads
+) {
+    /**
+     * Copies the live vertices and faces of halfmesh into points (xyz
+     * triples) and triangles (three vertex ids each). Vertex ids are looked
+     * up in a table sorted by address, so every thread can fill its own
+     * range of triangles
+     */
+    std::vector<std::pair<const HalfVertex*, int>> vertex_ids;
+    std::vector<const HalfVertex*> vertices;
+    std::vector<const HalfFace*> faces;
+    for (auto& v : halfmesh.vertices()) {
+        if (is_dead(v.get())) continue;
+        vertex_ids.emplace_back(v.get(), (int) vertices.size());
+        vertices.push_back(v.get());
+    }
+    for (auto& f : halfmesh.faces()) {
+        if (!is_dead(f.get())) faces.push_back(f.get());
+    }
+    auto by_address = [](const std::pair<const HalfVertex*, int>& a,
+        const std::pair<const HalfVertex*, int>& b) {
+        return std::less<const HalfVertex*>()(a.first, b.first);
+    };
+    std::sort(vertex_ids.begin(), vertex_ids.end(), by_address);
+
+    int num_vertices = vertices.size(), num_triangles = faces.size();
+    points.resize(3 * num_vertices);
+    triangles.resize(3 * num_triangles);
+
+    parallel_for(num_vertices, num_threads, [&](int, int begin, int end) {
+        for (int v = begin; v < end; ++v) {
+            for (int d = 0; d < 3; ++d) points[3 * v + d] = vertices[v]->point[d];
+        }
+    });
+    parallel_for(num_triangles, num_threads, [&](int, int begin, int end) {
+        for (int t = begin; t < end; ++t) {
+            const HalfEdge *halfedge = faces[t]->edge;
+            for (int i = 0; i < 3; ++i) {
+                auto found = std::lower_bound(vertex_ids.begin(), vertex_ids.end(),
+                    std::make_pair((const HalfVertex*) halfedge->vertex, 0), by_address);
+                triangles[3 * t + i] = found->second;
+                halfedge = halfedge->next;
+            }
+        }
+    });
+}
+
+} // flux
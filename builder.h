@@ -0,0 +1,53 @@
+#ifndef FLUX_REMESHER3D_BUILDER_H
+#define FLUX_REMESHER3D_BUILDER_H
+
+#include "halfedges.h"
+#include "mesh.h"
+#include "element.h"
+#include <vector>
+
+namespace flux {
+
+/**
+ * Bulk construction of a HalfEdgeMesh from an indexed triangle soup.
+ *
+ * Every triangle corner gives a halfedge with key (min, max) of its two
+ * vertex ids. The keys are sorted in parallel (sorted runs per thread, then
+ * pairwise merges), so twins end up next to each other. Keys seen once are
+ * boundary edges: they get a halfedge without face, linked into its boundary
+ * loop, and their vertices get index -1. Once the counts are known the
+ * containers are reserved and the elements created (still one allocation
+ * per element, HalfEdgeMesh owns each through its own pointer), then they
+ * are connected in parallel.
+ *
+ * Vertex i of the input is vertices()[i], halfedge j of triangle t is
+ * edges()[3t + j] (the one leaving vertex j, faces()[t]->edge for j = 0), and
+ * the boundary halfedges come after them. Vertices used by no triangle are
+ * created without edge. Returns false, leaving halfmesh empty, on an edge
+ * shared by more than two triangles or by two with opposite orientation, on
+ * a vertex where two boundary loops meet and on degenerate triangles.
+ *
+ * extract_halfmesh() is the inverse: the live vertices in container order
+ * and one triangle per live face.
+ */
+bool build_halfmesh(
+    const double *points,
+    int num_vertices,
+    const int *triangles,
+    int num_triangles,
+    HalfEdgeMesh<Triangle>& halfmesh,
+    int num_threads
+);
+
+bool build_halfmesh(const Mesh<Triangle>& mesh, HalfEdgeMesh<Triangle>& halfmesh, int num_threads);
+
+void extract_halfmesh(
+    const HalfEdgeMesh<Triangle>& halfmesh,
+    std::vector<double>& points,
+    std::vector<int>& triangles,
+    int num_threads
+);
+
+} // flux
+
+#endif
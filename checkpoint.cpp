@@ -0,0 +1,93 @@
+#include "checkpoint.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+
+namespace flux {
+
+// Identifies files written by save_checkpoint
+static const char CHECKPOINT_MAGIC[8] = {'R', '3', 'D', 'C', 'K', 'P', 'T', '1'};
+
+template<typename T>
+static void
+write_array(std::ofstream& file, const std::vector<T>& values) {
+    file.write((const char*) values.data(), values.size() * sizeof(T));
+}
+
+template<typename T>
+static void
+read_array(std::ifstream& file, std::vector<T>& values, size_t size) {
+    values.resize(size);
+    file.read((char*) values.data(), size * sizeof(T));
+}
+
+bool
+save_checkpoint(const std::string& filename, const Checkpoint& checkpoint) {
+    /**
+     * Writes checkpoint to filename through a temporary file next to it
+     *
+     * RETURNS: false if the file could not be written
+     */
+    std::string temporary = filename + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary);
+        if (!file) return false;
+
+        int32_t counts[4] = {
+            (int32_t) checkpoint.reports.size(),
+            (int32_t) (checkpoint.points.size() / 3),
+            (int32_t) (checkpoint.triangles.size() / 3),
+            (int32_t) (checkpoint.reference.size() / 9)
+        };
+        file.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+        file.write((const char*) counts, sizeof(counts));
+        write_array(file, checkpoint.reports);
+        write_array(file, checkpoint.points);
+        write_array(file, checkpoint.triangles);
+        write_array(file, checkpoint.reference);
+
+        file.close();
+        if (!file) return false;
+    }
+    return std::rename(temporary.c_str(), filename.c_str()) == 0;
+}
+
+bool
+load_checkpoint(const std::string& filename, Checkpoint& checkpoint) {
+    /**
+     * Reads a checkpoint written by save_checkpoint(). checkpoint is left
+     * unchanged on failure
+     *
+     * RETURNS: false if the file is missing, truncated or not a checkpoint
+     */
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) return false;
+
+    char magic[sizeof(CHECKPOINT_MAGIC)];
+    int32_t counts[4];
+    file.read(magic, sizeof(magic));
+    file.read((char*) counts, sizeof(counts));
+    if (!file || !std::equal(magic, magic + sizeof(magic), CHECKPOINT_MAGIC)) return false;
+    if (std::any_of(counts, counts + 4, [](int32_t count) { return count < 0; })) return false;
+
+    // A corrupt header must not size the arrays beyond the file
+    size_t expected = counts[0] * sizeof(IterationReport) + 3 * (size_t) counts[1] * sizeof(double)
+        + 3 * (size_t) counts[2] * sizeof(int) + 9 * (size_t) counts[3] * sizeof(double);
+    std::streampos start = file.tellg();
+    file.seekg(0, std::ios::end);
+    if ((size_t) (file.tellg() - start) < expected) return false;
+    file.seekg(start);
+
+    Checkpoint loaded;
+    read_array(file, loaded.reports, counts[0]);
+    read_array(file, loaded.points, 3 * (size_t) counts[1]);
+    read_array(file, loaded.triangles, 3 * (size_t) counts[2]);
+    read_array(file, loaded.reference, 9 * (size_t) counts[3]);
+    if (!file) return false;
+
+    std::swap(checkpoint, loaded);
+    return true;
+}
+
+} // flux
@@ -0,0 +1,42 @@
+#ifndef FLUX_REMESHER3D_CHECKPOINT_H
+#define FLUX_REMESHER3D_CHECKPOINT_H
+
+#include "report.h"
+#include "writer.h"
+#include <string>
+#include <vector>
+
+namespace flux {
+
+/**
+ * State of an incremental_relaxation run after a number of passes: one
+ * report per finished pass (their count is the pass counter, their sums the
+ * split/collapse/flip totals), the mesh as flat arrays and the corners of
+ * the reference surface projection pulls vertices back onto.
+ *
+ * Files hold a header (magic "R3DCKPT1" and the four counts as int32), then
+ * the arrays in the order below, in native byte order.
+ */
+struct Checkpoint {
+    std::vector<IterationReport> reports;
+    std::vector<double> points;         // xyz per vertex
+    std::vector<int> triangles;         // three vertex ids per triangle
+    std::vector<double> reference;      // nine coordinates per triangle
+};
+
+bool save_checkpoint(const std::string& filename, const Checkpoint& checkpoint);
+bool load_checkpoint(const std::string& filename, Checkpoint& checkpoint);
+
+/**
+ * Writes checkpoints on a background thread with save_checkpoint(), so an
+ * interrupted write leaves the previous checkpoint intact.
+ */
+class CheckpointWriter : public BackgroundWriter<Checkpoint> {
+public:
+
+CheckpointWriter() : BackgroundWriter<Checkpoint>(save_checkpoint) {  }
+};
+
+} // flux
+
+#endif
@@ -0,0 +1,473 @@
+#include "compactmesh.h"
+#include "tombstone.h"
+#include "parallel.h"
+#include <algorithm>
+#include <functional>
+
+namespace flux {
+
+/**
+ * CONVERSION
+ */
+void
+CompactMesh::import_mesh(HalfEdgeMesh<Triangle>& halfmesh) {
+    /**
+     * Replaces the contents with the live elements of halfmesh, then erases
+     * every element of halfmesh so only one copy of the mesh is held at a time.
+     *
+     * No hash tables: once its HalfVertex::index is saved, every live vertex
+     * holds its new id there (halfmesh is emptied anyway), and faces are
+     * looked up in one table sorted by address, 16 bytes per face
+     */
+    clear();
+
+    int num_vertices = 0, num_faces = 0;
+    for (auto& v : halfmesh.vertices()) {
+        if (!is_dead(v.get())) num_vertices++;
+    }
+    for (auto& f : halfmesh.faces()) {
+        if (!is_dead(f.get())) num_faces++;
+    }
+    _points.reserve(3 * num_vertices);
+    _outgoing.reserve(num_vertices);
+    _indices.reserve(num_vertices);
+    _corners.reserve(3 * num_faces);
+    _twins.reserve(3 * num_faces);
+
+    for (auto& v : halfmesh.vertices()) {
+        if (is_dead(v.get())) continue;
+        v->index = add_vertex(v->point.data(), v->index);
+    }
+
+    // Corner 0 of every face is the halfedge the face points at
+    std::vector<std::pair<const HalfFace*, index_t>> face_ids;
+    face_ids.reserve(num_faces);
+    for (auto& f : halfmesh.faces()) {
+        if (is_dead(f.get())) continue;
+
+        HalfEdge *halfedge = f->edge;
+        index_t v[3];
+        for (int i = 0; i < 3; ++i) {
+            v[i] = halfedge->vertex->index;
+            halfedge = halfedge->next;
+        }
+        face_ids.emplace_back(f.get(), add_face(v[0], v[1], v[2]));
+    }
+
+    auto by_address = [](const std::pair<const HalfFace*, index_t>& a,
+        const std::pair<const HalfFace*, index_t>& b) {
+        return std::less<const HalfFace*>()(a.first, b.first);
+    };
+    std::sort(face_ids.begin(), face_ids.end(), by_address);
+
+    // The twin of a halfedge is found from the id of its face and its corner
+    for (auto& entry : face_ids) {
+        const HalfEdge *halfedge = entry.first->edge;
+        for (int i = 0; i < 3; ++i, halfedge = halfedge->next) {
+            const HalfEdge *twin = halfedge->twin;
+            if (!twin->face) continue;
+
+            auto found = std::lower_bound(face_ids.begin(), face_ids.end(),
+                std::make_pair((const HalfFace*) twin->face, 0), by_address);
+            int corner = 0;
+            for (const HalfEdge *e = twin->face->edge; e != twin; e = e->next) corner++;
+            _twins[3 * entry.second + i] = 3 * found->second + corner;
+        }
+    }
+    std::vector<std::pair<const HalfFace*, index_t>>().swap(face_ids);
+
+    // Boundary vertices start at their boundary halfedge
+    for (index_t h = 0; h < nb_halfedges(); ++h) {
+        index_t v = _corners[h];
+        if (_outgoing[v] < 0 || _twins[h] < 0) _outgoing[v] = h;
+    }
+
+    halfmesh.vertices().clear();
+    halfmesh.edges().clear();
+    halfmesh.faces().clear();
+}
+
+void
+CompactMesh::export_mesh(HalfEdgeMesh<Triangle>& halfmesh) const {
+    /**
+     * Creates the live elements in halfmesh, which must be empty, in id
+     * order. Every boundary edge gets a halfedge without face, linked into
+     * its boundary loop with next and prev
+     */
+    std::vector<HalfVertex*> vertices(nb_vertices(), nullptr);
+    std::vector<HalfEdge*> halfedges(nb_halfedges(), nullptr);
+    std::vector<HalfEdge*> boundary_edges(nb_vertices(), nullptr);
+
+    for (index_t v = 0; v < nb_vertices(); ++v) {
+        if (is_dead_vertex(v)) continue;
+        vertices[v] = halfmesh.create_vertex(3, point(v));
+        vertices[v]->index = _indices[v];
+    }
+    for (index_t f = 0; f < nb_faces(); ++f) {
+        if (is_dead_face(f)) continue;
+
+        HalfFace *face = halfmesh.create_face();
+        for (int i = 0; i < 3; ++i) {
+            halfedges[3 * f + i] = halfmesh.create_edge();
+            halfedges[3 * f + i]->face = face;
+        }
+        face->edge = halfedges[3 * f];
+    }
+
+    for (index_t h = 0; h < nb_halfedges(); ++h) {
+        HalfEdge *halfedge = halfedges[h];
+        if (!halfedge) continue;
+
+        halfedge->vertex = vertices[_corners[h]];
+        halfedge->next = halfedges[next(h)];
+        halfedge->prev = halfedges[prev(h)];
+        if (_twins[h] >= 0) {
+            halfedge->twin = halfedges[_twins[h]];
+            continue;
+        }
+
+        // The boundary halfedge runs the other way, from the head of h
+        HalfEdge *boundary = halfmesh.create_edge();
+        boundary->vertex = vertices[head(h)];
+        boundary->twin = halfedge;
+        halfedge->twin = boundary;
+        boundary_edges[head(h)] = boundary;
+    }
+    for (index_t h = 0; h < nb_halfedges(); ++h) {
+        if (!halfedges[h] || _twins[h] >= 0) continue;
+
+        // The next boundary halfedge starts where this one ends, at the tail of h
+        HalfEdge *boundary = halfedges[h]->twin;
+        boundary->next = boundary_edges[_corners[h]];
+        boundary->next->prev = boundary;
+    }
+
+    for (index_t v = 0; v < nb_vertices(); ++v) {
+        if (vertices[v]) vertices[v]->edge = halfedges[_outgoing[v]];
+    }
+}
+
+void
+CompactMesh::extract(std::vector<double>& points, std::vector<int>& triangles) const {
+    /**
+     * Copies the live vertices (renumbered in id order) and faces into points
+     * (xyz triples) and triangles (three vertex ids each)
+     */
+    std::vector<index_t> vertex_ids(nb_vertices(), -1);
+    points.clear();
+    triangles.clear();
+    for (index_t v = 0; v < nb_vertices(); ++v) {
+        if (is_dead_vertex(v)) continue;
+        vertex_ids[v] = points.size() / 3;
+        points.insert(points.end(), point(v), point(v) + 3);
+    }
+    for (index_t h = 0; h < nb_halfedges(); ++h) {
+        if (!is_dead_face(face(h))) triangles.push_back(vertex_ids[_corners[h]]);
+    }
+}
+
+void
+CompactMesh::compact() {
+    /**
+     * Drops removed faces and vertices and renumbers the survivors, keeping
+     * their relative order
+     */
+    std::vector<index_t> vertex_ids(nb_vertices(), -1);
+    std::vector<index_t> face_ids(nb_faces(), -1);
+    index_t num_vertices = 0, num_faces = 0;
+    for (index_t v = 0; v < nb_vertices(); ++v) {
+        if (!is_dead_vertex(v)) vertex_ids[v] = num_vertices++;
+    }
+    for (index_t f = 0; f < nb_faces(); ++f) {
+        if (!is_dead_face(f)) face_ids[f] = num_faces++;
+    }
+
+    auto moved = [&](index_t h) {
+        return (h < 0) ? h : 3 * face_ids[face(h)] + h % 3;
+    };
+
+    for (index_t v = 0; v < nb_vertices(); ++v) {
+        index_t id = vertex_ids[v];
+        if (id < 0) continue;
+        for (int d = 0; d < 3; ++d) _points[3 * id + d] = _points[3 * v + d];
+        _outgoing[id] = moved(_outgoing[v]);
+        _indices[id] = _indices[v];
+    }
+    for (index_t h = 0; h < nb_halfedges(); ++h) {
+        if (is_dead_face(face(h))) continue;
+        index_t id = moved(h);
+        _corners[id] = vertex_ids[_corners[h]];
+        _twins[id] = moved(_twins[h]);
+    }
+
+    _points.resize(3 * num_vertices);
+    _outgoing.resize(num_vertices);
+    _indices.resize(num_vertices);
+    _corners.resize(3 * num_faces);
+    _twins.resize(3 * num_faces);
+}
+
+void
+CompactMesh::clear() {
+    _points.clear();
+    _outgoing.clear();
+    _indices.clear();
+    _corners.clear();
+    _twins.clear();
+}
+
+/**
+ * NAVIGATION
+ */
+void
+CompactMesh::get_outgoing(index_t v, std::vector<index_t>& halfedges) const {
+    /**
+     * Collects the halfedges leaving v by rotating with twin(prev(h)). On the
+     * boundary the rotation starts at the boundary halfedge of v and ends at
+     * the face whose previous halfedge has no twin
+     */
+    halfedges.clear();
+    index_t start = _outgoing[v], h = start;
+    do {
+        halfedges.push_back(h);
+        h = _twins[prev(h)];
+    } while (h >= 0 && h != start);
+}
+
+void
+CompactMesh::get_onering(index_t v, std::vector<index_t>& vertices) const {
+    /**
+     * Collects the neighbours of v, in rotation order
+     */
+    vertices.clear();
+    index_t start = _outgoing[v], h = start;
+    do {
+        vertices.push_back(head(h));
+        if (_twins[prev(h)] < 0) {
+            // Last face of a boundary fan, its previous halfedge comes from the other neighbour
+            vertices.push_back(_corners[prev(h)]);
+            break;
+        }
+        h = _twins[prev(h)];
+    } while (h != start);
+}
+
+int
+CompactMesh::valence(index_t v) const {
+    /**
+     * Number of neighbours of v
+     */
+    int count = 0;
+    index_t start = _outgoing[v], h = start;
+    do {
+        count++;
+        if (_twins[prev(h)] < 0) return count + 1;
+        h = _twins[prev(h)];
+    } while (h != start);
+    return count;
+}
+
+/**
+ * OPERATIONS
+ */
+CompactMesh::index_t
+CompactMesh::split(index_t h, const double *midpoint) {
+    /**
+     * Splits halfedge h (q -> p, with r opposite in its face and s opposite
+     * in its twin's) at midpoint. The face of h becomes (q, m, r) and the one
+     * of its twin (m, q, s); (m, p, r) and (p, m, s) are added. Without twin
+     * only the first half is done and m is a boundary vertex
+     *
+     * RETURNS: the new vertex m
+     */
+    index_t t = _twins[h];
+    index_t h1 = next(h), h2 = prev(h);
+    index_t p = _corners[h1], r = _corners[h2];
+    index_t m = add_vertex(midpoint, (t < 0) ? -1 : 0);
+
+    index_t a = 3 * add_face(m, p, r);
+    _corners[h1] = m;
+    link(a + 1, _twins[h1]);
+    link(h1, a + 2);
+    replace_outgoing(p, h1, a + 1);
+
+    if (t < 0) {
+        // m -> p is on the boundary now
+        _outgoing[m] = a;
+        return m;
+    }
+    _outgoing[m] = h1;
+
+    index_t t2 = prev(t);
+    index_t s = _corners[t2];
+    index_t b = 3 * add_face(p, m, s);
+    _corners[t] = m;
+    link(b + 2, _twins[t2]);
+    link(t2, b + 1);
+    link(a, b);
+    replace_outgoing(p, t, b);
+    replace_outgoing(s, t2, b + 2);
+    return m;
+}
+
+void
+CompactMesh::collapse(index_t h) {
+    /**
+     * Collapses interior halfedge h (q -> p) into q, which moves to the
+     * position of p. The faces of h and its twin are removed and their outer
+     * halfedges become twins of each other. Validity (link condition, flips)
+     * is up to the caller
+     */
+    index_t t = _twins[h];
+    index_t h1 = next(h), h2 = prev(h), t1 = next(t), t2 = prev(t);
+    index_t q = _corners[h], p = _corners[t], r = _corners[h2], s = _corners[t2];
+    index_t a = _twins[h1], b = _twins[h2], c = _twins[t1], d = _twins[t2];
+
+    get_outgoing(p, _ring);
+    for (index_t e : _ring) _corners[e] = q;
+    for (int i = 0; i < 3; ++i) _points[3 * q + i] = _points[3 * p + i];
+
+    link(a, b);
+    link(c, d);
+    replace_outgoing(q, h, b);
+    replace_outgoing(q, t1, b);
+    replace_outgoing(r, h2, a);
+    replace_outgoing(s, t2, c);
+
+    for (int i = 0; i < 3; ++i) {
+        _corners[3 * face(h) + i] = _twins[3 * face(h) + i] = -1;
+        _corners[3 * face(t) + i] = _twins[3 * face(t) + i] = -1;
+    }
+    _outgoing[p] = -1;
+}
+
+void
+CompactMesh::flip(index_t h) {
+    /**
+     * Turns interior halfedge h (q -> p) into s -> r, replacing triangles
+     * (q, p, r), (p, q, s) with (s, r, q), (r, s, p) in the same two faces
+     */
+    index_t t = _twins[h];
+    index_t h1 = next(h), h2 = prev(h), t1 = next(t), t2 = prev(t);
+    index_t q = _corners[h], p = _corners[t], r = _corners[h2], s = _corners[t2];
+    index_t a = _twins[h1], b = _twins[h2], c = _twins[t1], d = _twins[t2];
+
+    _corners[h] = s;
+    _corners[h1] = r;
+    _corners[h2] = q;
+    _corners[t] = r;
+    _corners[t1] = s;
+    _corners[t2] = p;
+
+    link(h1, b);
+    link(h2, c);
+    link(t1, d);
+    link(t2, a);
+
+    replace_outgoing(q, h, h2);
+    replace_outgoing(q, t1, h2);
+    replace_outgoing(p, h1, t2);
+    replace_outgoing(p, t, t2);
+    replace_outgoing(r, h2, h1);
+    replace_outgoing(s, t2, t1);
+}
+
+/**
+ * TANGENTIAL RELAXATION
+ */
+void
+CompactMesh::relax(double factor, int num_threads) {
+    /**
+     * Moves every vertex to p' = q + (n * (p - q)) * n (q the one-ring
+     * centroid, n the averaged one-ring face normal) from the old positions
+     * of all vertices at once, factor of the way when factor != 1. Same
+     * update as SoAGeometry's kernels
+     */
+    _relaxed = _points;
+
+    parallel_for(nb_vertices(), num_threads, [&](int, int begin, int end) {
+        std::vector<index_t> halfedges, neighbours;
+        for (index_t v = begin; v < end; ++v) {
+            if (is_dead_vertex(v)) continue;
+            get_outgoing(v, halfedges);
+            get_onering(v, neighbours);
+
+            double n[3] = {0.0, 0.0, 0.0};
+            for (index_t h : halfedges) {
+                const double *p0 = point(_corners[3 * face(h)]);
+                const double *p1 = point(_corners[3 * face(h) + 1]);
+                const double *p2 = point(_corners[3 * face(h) + 2]);
+                double a[3], b[3];
+                for (int d = 0; d < 3; ++d) {
+                    a[d] = p1[d] - p0[d];
+                    b[d] = p2[d] - p0[d];
+                }
+                for (int i = 0; i < 3; ++i) {
+                    int j = (i + 1) % 3, k = (i + 2) % 3;
+                    n[i] += (a[j] * b[k]) - (a[k] * b[j]);
+                }
+            }
+
+            double q[3] = {0.0, 0.0, 0.0};
+            for (index_t u : neighbours) {
+                for (int d = 0; d < 3; ++d) q[d] += point(u)[d];
+            }
+
+            const double *p = point(v);
+            double dot = 0.0;
+            for (int d = 0; d < 3; ++d) {
+                n[d] /= halfedges.size();
+                q[d] /= neighbours.size();
+                dot += n[d] * (p[d] - q[d]);
+            }
+            for (int d = 0; d < 3; ++d) {
+                double relaxed = q[d] + dot * n[d];
+                _relaxed[3 * v + d] = (factor == 1.0) ? relaxed : p[d] + factor * (relaxed - p[d]);
+            }
+        }
+    });
+
+    _points.swap(_relaxed);
+}
+
+/**
+ * HELPER METHODS
+ */
+CompactMesh::index_t
+CompactMesh::add_vertex(const double *point, index_t index) {
+    /**
+     * Appends a vertex without outgoing halfedge (set by the caller)
+     */
+    _points.insert(_points.end(), point, point + 3);
+    _outgoing.push_back(-1);
+    _indices.push_back(index);
+    return _outgoing.size() - 1;
+}
+
+CompactMesh::index_t
+CompactMesh::add_face(index_t v0, index_t v1, index_t v2) {
+    /**
+     * Appends a face with corners v0, v1, v2 and no twins yet
+     */
+    _corners.push_back(v0);
+    _corners.push_back(v1);
+    _corners.push_back(v2);
+    _twins.insert(_twins.end(), 3, -1);
+    return nb_faces() - 1;
+}
+
+void
+CompactMesh::link(index_t h, index_t twin) {
+    /**
+     * Makes h and twin twins of each other. Either may be -1 (boundary)
+     */
+    if (h >= 0) _twins[h] = twin;
+    if (twin >= 0) _twins[twin] = h;
+}
+
+void
+CompactMesh::replace_outgoing(index_t v, index_t old_halfedge, index_t new_halfedge) {
+    if (_outgoing[v] == old_halfedge) _outgoing[v] = new_halfedge;
+}
+
+} // flux
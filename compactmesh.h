@@ -0,0 +1,90 @@
+#ifndef FLUX_REMESHER3D_COMPACTMESH_H
+#define FLUX_REMESHER3D_COMPACTMESH_H
+
+#include "halfedges.h"
+#include "element.h"
+#include <cstdint>
+#include <vector>
+
+namespace flux {
+
+/**
+ * Index-based half-edge mesh for remeshing large triangle meshes.
+ *
+ * Halfedges are the corners of the triangles: halfedge 3f + i is corner i of
+ * face f and runs from its vertex to the vertex of the next corner, so next,
+ * prev and face are arithmetic and only the vertex and twin of every
+ * halfedge are stored, as 32-bit ids. Boundary edges have a single halfedge,
+ * whose twin is -1. Every vertex keeps one outgoing halfedge, on the boundary
+ * the one whose twin is -1, so rotating with twin(prev(h)) visits all of
+ * them.
+ *
+ * Removed faces and vertices keep their ids (vertex -1 on the corners,
+ * outgoing halfedge -1 on the vertex) until compact() renumbers the
+ * survivors.
+ * import_mesh() takes the elements of a HalfEdgeMesh (which is left empty)
+ * and export_mesh() creates them again.
+ */
+class CompactMesh {
+public:
+
+typedef int32_t index_t;
+
+void import_mesh(HalfEdgeMesh<Triangle>& halfmesh);
+void export_mesh(HalfEdgeMesh<Triangle>& halfmesh) const;
+void extract(std::vector<double>& points, std::vector<int>& triangles) const;
+void compact();
+void clear();
+
+/* Navigation */
+static index_t face(index_t h) { return h / 3; }
+static index_t next(index_t h) { return (h % 3 == 2) ? h - 2 : h + 1; }
+static index_t prev(index_t h) { return (h % 3 == 0) ? h + 2 : h - 1; }
+index_t twin(index_t h) const { return _twins[h]; }
+index_t vertex(index_t h) const { return _corners[h]; }
+index_t head(index_t h) const { return _corners[next(h)]; }
+index_t outgoing(index_t v) const { return _outgoing[v]; }
+void get_outgoing(index_t v, std::vector<index_t>& halfedges) const;
+void get_onering(index_t v, std::vector<index_t>& vertices) const;
+int valence(index_t v) const;
+
+/* Sizes and state */
+int nb_vertices() const { return _outgoing.size(); }
+int nb_halfedges() const { return _corners.size(); }
+int nb_faces() const { return _corners.size() / 3; }
+bool is_dead_face(index_t f) const { return _corners[3 * f] < 0; }
+bool is_dead_vertex(index_t v) const { return _outgoing[v] < 0; }
+bool is_boundary_edge(index_t h) const { return _twins[h] < 0; }
+bool is_boundary_vertex(index_t v) const { return _indices[v] <= -1; }
+
+/* Geometry */
+double* point(index_t v) { return &_points[3 * v]; }
+const double* point(index_t v) const { return &_points[3 * v]; }
+
+/* Operations */
+index_t split(index_t h, const double *midpoint);
+void collapse(index_t h);
+void flip(index_t h);
+void relax(double factor, int num_threads);
+
+private:
+std::vector<double> _points;
+std::vector<index_t> _outgoing;
+std::vector<index_t> _indices;   // HalfVertex::index, <= -1 on the boundary
+
+std::vector<index_t> _corners;
+std::vector<index_t> _twins;
+
+// Scratch space of collapse() and relax()
+std::vector<index_t> _ring;
+std::vector<double> _relaxed;
+
+index_t add_vertex(const double *point, index_t index);
+index_t add_face(index_t v0, index_t v1, index_t v2);
+void link(index_t h, index_t twin);
+void replace_outgoing(index_t v, index_t old_halfedge, index_t new_halfedge);
+};
+
+} // flux
+
+#endif
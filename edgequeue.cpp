@@ -0,0 +1,70 @@
+#include "edgequeue.h"
+
+namespace flux {
+
+EdgeQueue::EdgeQueue(bool largest_first) :
+_largest_first(largest_first)
+{  }
+
+void
+EdgeQueue::push(HalfEdge *halfedge, int v0, int v1, double ratio) {
+    /**
+     * Adds halfedge (going from vertex v0 to v1) with the current stamps of
+     * its endpoints
+     */
+    Entry entry;
+    entry.key = _largest_first ? ratio : -ratio;
+    entry.halfedge = halfedge;
+    entry.v0 = v0;
+    entry.v1 = v1;
+    entry.s0 = version(v0);
+    entry.s1 = version(v1);
+    _heap.push(entry);
+}
+
+bool
+EdgeQueue::pop(HalfEdge*& halfedge, double& ratio) {
+    /**
+     * Pops the best entry that is still valid, dropping stale ones on the way
+     *
+     * RETURNS: 0 once the queue is empty
+     */
+    while (!_heap.empty()) {
+        Entry entry = _heap.top();
+        _heap.pop();
+
+        if (entry.s0 != version(entry.v0) || entry.s1 != version(entry.v1)) continue;
+
+        halfedge = entry.halfedge;
+        ratio = _largest_first ? entry.key : -entry.key;
+        return 1;
+    }
+    return 0;
+}
+
+void
+EdgeQueue::touch(int vertex) {
+    /**
+     * Invalidates every queued halfedge that starts or ends at vertex
+     */
+    if (vertex < 0) return;
+    if (vertex >= (int) _versions.size()) _versions.resize(vertex + 1, 0);
+    _versions[vertex]++;
+}
+
+void
+EdgeQueue::clear() {
+    /**
+     * Drops all entries and stamps
+     */
+    _heap = std::priority_queue<Entry>();
+    _versions.clear();
+}
+
+unsigned
+EdgeQueue::version(int vertex) const {
+    if (vertex >= (int) _versions.size()) return 0;
+    return _versions[vertex];
+}
+
+} // flux
@@ -0,0 +1,50 @@
+#ifndef FLUX_REMESHER3D_EDGEQUEUE_H
+#define FLUX_REMESHER3D_EDGEQUEUE_H
+
+#include "halfedges.h"
+#include <queue>
+#include <vector>
+
+namespace flux {
+
+/**
+ * Priority queue of halfedges keyed by their length/target ratio, with lazy
+ * invalidation.
+ *
+ * Every entry remembers the version stamps of its two endpoint ids (as
+ * numbered by Adjacency). A split or collapse only ever changes or frees
+ * halfedges around the vertices it touches, so touching those vertices is
+ * enough to turn every affected entry stale; stale entries are skipped when
+ * they reach the top instead of being searched for and erased.
+ */
+class EdgeQueue {
+public:
+
+EdgeQueue(bool largest_first);
+
+void push(HalfEdge *halfedge, int v0, int v1, double ratio);
+bool pop(HalfEdge*& halfedge, double& ratio);
+void touch(int vertex);
+void clear();
+bool empty() const { return _heap.empty(); }
+
+private:
+struct Entry {
+    double key;
+    HalfEdge *halfedge;
+    int v0, v1;
+    unsigned s0, s1;
+
+    bool operator<(const Entry& other) const { return key < other.key; }
+};
+
+bool _largest_first;
+std::priority_queue<Entry> _heap;
+std::vector<unsigned> _versions;
+
+unsigned version(int vertex) const;
+};
+
+} // flux
+
+#endif
@@ -0,0 +1,113 @@
+#include "exact.h"
+#include <cmath>
+#include <vector>
+
+namespace flux {
+
+/**
+ * An expansion is a sum of doubles, nonoverlapping and ordered by increasing
+ * magnitude, so its sign is the sign of its last component
+ */
+typedef std::vector<double> Expansion;
+
+static void
+two_sum(double a, double b, double& x, double& y) {
+    x = a + b;
+    double b_virtual = x - a;
+    double a_virtual = x - b_virtual;
+    y = (a - a_virtual) + (b - b_virtual);
+}
+
+static Expansion
+difference(double a, double b) {
+    double x, y;
+    two_sum(a, -b, x, y);
+    Expansion e;
+    if (y != 0.0) e.push_back(y);
+    if (x != 0.0) e.push_back(x);
+    return e;
+}
+
+static Expansion
+grow(const Expansion& e, double b) {
+    Expansion h;
+    double q = b;
+    for (double component : e) {
+        double sum, error;
+        two_sum(q, component, sum, error);
+        if (error != 0.0) h.push_back(error);
+        q = sum;
+    }
+    if (q != 0.0) h.push_back(q);
+    return h;
+}
+
+static Expansion
+add(const Expansion& e, const Expansion& f) {
+    Expansion h = e;
+    for (double component : f) h = grow(h, component);
+    return h;
+}
+
+static Expansion
+scale(const Expansion& e, double b) {
+    Expansion h;
+    double q = 0.0;
+    for (double component : e) {
+        // Product and its rounding error (exact with fma)
+        double product = component * b;
+        double error = std::fma(component, b, -product);
+
+        double sum, low;
+        two_sum(q, error, sum, low);
+        if (low != 0.0) h.push_back(low);
+        two_sum(product, sum, q, low);
+        if (low != 0.0) h.push_back(low);
+    }
+    if (q != 0.0) h.push_back(q);
+    return h;
+}
+
+static Expansion
+multiply(const Expansion& e, const Expansion& f) {
+    Expansion h;
+    for (double component : f) h = add(h, scale(e, component));
+    return h;
+}
+
+static Expansion
+negate(Expansion e) {
+    for (double& component : e) component = -component;
+    return e;
+}
+
+static void
+cross(const Expansion *a, const Expansion *b, Expansion *n) {
+    for (int i = 0; i < 3; ++i) {
+        int j = (i + 1) % 3, k = (i + 2) % 3;
+        n[i] = add(multiply(a[j], b[k]), negate(multiply(a[k], b[j])));
+    }
+}
+
+int
+normal_dot_sign(const double *a, const double *b, const double *u, const double *w) {
+    Expansion ua[3], wa[3], ub[3], wb[3];
+    for (int d = 0; d < 3; ++d) {
+        ua[d] = difference(u[d], a[d]);
+        wa[d] = difference(w[d], a[d]);
+        ub[d] = difference(u[d], b[d]);
+        wb[d] = difference(w[d], b[d]);
+    }
+
+    Expansion n0[3], n1[3];
+    cross(ua, wa, n0);
+    cross(ub, wb, n1);
+
+    Expansion dot;
+    for (int d = 0; d < 3; ++d) dot = add(dot, multiply(n0[d], n1[d]));
+
+    if (dot.empty()) return 0;
+    return (dot.back() > 0.0) ? 1 : -1;
+}
+
+} // flux
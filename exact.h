@@ -0,0 +1,18 @@
+#ifndef FLUX_REMESHER3D_EXACT_H
+#define FLUX_REMESHER3D_EXACT_H
+
+namespace flux {
+
+/**
+ * Exact sign of dot((u - a) x (w - a), (u - b) x (w - b)), i.e. whether
+ * triangle (a, u, w) and triangle (b, u, w) face the same way. Evaluated
+ * with floating-point expansions (Shewchuk's arithmetic) on the input
+ * coordinates only, so no rounded intermediate decides the sign.
+ *
+ * RETURNS: 1, 0 or -1
+ */
+int normal_dot_sign(const double *a, const double *b, const double *u, const double *w);
+
+} // flux
+
+#endif
@@ -0,0 +1,276 @@
+#include "geometry.h"
+#include "parallel.h"
+
+namespace flux {
+
+void
+SoAGeometry::gather(const Adjacency& adjacency, int num_threads) {
+    /**
+     * Copies the coordinates of every vertex of adjacency into the x/y/z arrays.
+     * Removed vertices are kept as zeros so ids stay aligned
+     */
+    int num_vertices = adjacency.nb_vertices();
+    _x.resize(num_vertices);
+    _y.resize(num_vertices);
+    _z.resize(num_vertices);
+
+    parallel_for(num_vertices, num_threads, [&](int, int begin, int end) {
+        HalfVertex *vertex;
+        for (int v = begin; v < end; ++v) {
+            vertex = adjacency.vertex(v);
+            if (!vertex) {
+                _x[v] = _y[v] = _z[v] = 0.0;
+                continue;
+            }
+            _x[v] = vertex->point[0];
+            _y[v] = vertex->point[1];
+            _z[v] = vertex->point[2];
+        }
+    });
+}
+
+void
+SoAGeometry::scatter(const Adjacency& adjacency, int num_threads) const {
+    /**
+     * Writes the relaxed coordinates back into the vertices of adjacency
+     */
+    scatter_arrays(adjacency, _rx, _ry, _rz, num_threads);
+}
+
+void
+SoAGeometry::scatter_points(const Adjacency& adjacency, int num_threads) const {
+    /**
+     * Writes the (in place relaxed) vertex coordinates back into the vertices
+     * of adjacency
+     */
+    scatter_arrays(adjacency, _x, _y, _z, num_threads);
+}
+
+void
+SoAGeometry::compute_face_normals(const Adjacency& adjacency, int num_threads) {
+    /**
+     * Computes (b - a) x (c - a) for every triangle (a, b, c). Removed faces
+     * get a zero normal
+     */
+    int num_faces = adjacency.nb_faces();
+    _face_nx.resize(num_faces);
+    _face_ny.resize(num_faces);
+    _face_nz.resize(num_faces);
+
+    parallel_for(num_faces, num_threads, [&](int, int begin, int end) {
+        const int *triangles = adjacency.triangle(0);
+        const double *x = _x.data(), *y = _y.data(), *z = _z.data();
+        double *nx = _face_nx.data(), *ny = _face_ny.data(), *nz = _face_nz.data();
+
+        for (int f = begin; f < end; ++f) {
+            int i0 = triangles[3 * f];
+            int i1 = triangles[3 * f + 1];
+            int i2 = triangles[3 * f + 2];
+            if (i0 < 0 || i1 < 0 || i2 < 0) {
+                nx[f] = ny[f] = nz[f] = 0.0;
+                continue;
+            }
+
+            double ax = x[i1] - x[i0], ay = y[i1] - y[i0], az = z[i1] - z[i0];
+            double bx = x[i2] - x[i0], by = y[i2] - y[i0], bz = z[i2] - z[i0];
+
+            nx[f] = (ay * bz) - (az * by);
+            ny[f] = (az * bx) - (ax * bz);
+            nz[f] = (ax * by) - (ay * bx);
+        }
+    });
+}
+
+void
+SoAGeometry::compute_vertex_normals(const Adjacency& adjacency, int num_threads) {
+    /**
+     * Averages the face normals of every vertex's one-ring. Needs
+     * compute_face_normals() first
+     */
+    int num_vertices = adjacency.nb_vertices();
+    _nx.resize(num_vertices);
+    _ny.resize(num_vertices);
+    _nz.resize(num_vertices);
+
+    parallel_for(num_vertices, num_threads, [&](int, int begin, int end) {
+        const double *fx = _face_nx.data(), *fy = _face_ny.data(), *fz = _face_nz.data();
+
+        for (int v = begin; v < end; ++v) {
+            int num_faces = adjacency.nb_incident_faces(v);
+            const int *faces = adjacency.incident_faces(v);
+
+            double sx = 0.0, sy = 0.0, sz = 0.0;
+            for (int i = 0; i < num_faces; ++i) {
+                sx += fx[faces[i]];
+                sy += fy[faces[i]];
+                sz += fz[faces[i]];
+            }
+
+            _nx[v] = sx / num_faces;
+            _ny[v] = sy / num_faces;
+            _nz[v] = sz / num_faces;
+        }
+    });
+}
+
+void
+SoAGeometry::compute_centroids(const Adjacency& adjacency, int num_threads) {
+    /**
+     * Averages the coordinates of every vertex's one-ring neighbours
+     */
+    int num_vertices = adjacency.nb_vertices();
+    _qx.resize(num_vertices);
+    _qy.resize(num_vertices);
+    _qz.resize(num_vertices);
+
+    parallel_for(num_vertices, num_threads, [&](int, int begin, int end) {
+        const double *x = _x.data(), *y = _y.data(), *z = _z.data();
+
+        for (int v = begin; v < end; ++v) {
+            int valence = adjacency.valence(v);
+            const int *neighbours = adjacency.neighbours(v);
+
+            double sx = 0.0, sy = 0.0, sz = 0.0;
+            for (int i = 0; i < valence; ++i) {
+                sx += x[neighbours[i]];
+                sy += y[neighbours[i]];
+                sz += z[neighbours[i]];
+            }
+
+            _qx[v] = sx / (double) valence;
+            _qy[v] = sy / (double) valence;
+            _qz[v] = sz / (double) valence;
+        }
+    });
+}
+
+void
+SoAGeometry::compute_relaxed_points(double factor, int num_threads) {
+    /**
+     * p' = q + (n * (p - q)) * n for every vertex, moved only factor of the way
+     * from p when factor != 1. Needs the vertex normals and centroids first.
+     * This loop is purely contiguous and vectorizes fully
+     */
+    int num_vertices = _x.size();
+    _rx.resize(num_vertices);
+    _ry.resize(num_vertices);
+    _rz.resize(num_vertices);
+
+    parallel_for(num_vertices, num_threads, [&](int, int begin, int end) {
+        const double *x = _x.data(), *y = _y.data(), *z = _z.data();
+        const double *nx = _nx.data(), *ny = _ny.data(), *nz = _nz.data();
+        const double *qx = _qx.data(), *qy = _qy.data(), *qz = _qz.data();
+        double *rx = _rx.data(), *ry = _ry.data(), *rz = _rz.data();
+
+        for (int v = begin; v < end; ++v) {
+            double d = nx[v] * (x[v] - qx[v]) + ny[v] * (y[v] - qy[v])
+                + nz[v] * (z[v] - qz[v]);
+
+            rx[v] = qx[v] + d * nx[v];
+            ry[v] = qy[v] + d * ny[v];
+            rz[v] = qz[v] + d * nz[v];
+        }
+
+        if (factor == 1.0) return;
+        for (int v = begin; v < end; ++v) {
+            rx[v] = x[v] + factor * (rx[v] - x[v]);
+            ry[v] = y[v] + factor * (ry[v] - y[v]);
+            rz[v] = z[v] + factor * (rz[v] - z[v]);
+        }
+    });
+}
+
+void
+SoAGeometry::relax_in_place(
+    const Adjacency& adjacency,
+    const int *vertices,
+    int num_vertices,
+    double factor,
+    int num_threads
+) {
+    /**
+     * Gauss-Seidel step for the listed vertices: same update as the batch
+     * kernels above, but normals and centroids are taken from the current
+     * x/y/z and the result overwrites them. The listed vertices must not be
+     * neighbours of each other (one colour of Adjacency::color), so each one
+     * only reads coordinates no other thread writes
+     */
+    parallel_for(num_vertices, num_threads, [&](int, int begin, int end) {
+        double *x = _x.data(), *y = _y.data(), *z = _z.data();
+        const int *triangles = adjacency.triangle(0);
+
+        for (int i = begin; i < end; ++i) {
+            int v = vertices[i];
+
+            // Averaged one-ring face normal
+            int num_faces = adjacency.nb_incident_faces(v);
+            const int *faces = adjacency.incident_faces(v);
+            double nx = 0.0, ny = 0.0, nz = 0.0;
+            for (int j = 0; j < num_faces; ++j) {
+                const int *t = triangles + 3 * faces[j];
+                double ax = x[t[1]] - x[t[0]], ay = y[t[1]] - y[t[0]], az = z[t[1]] - z[t[0]];
+                double bx = x[t[2]] - x[t[0]], by = y[t[2]] - y[t[0]], bz = z[t[2]] - z[t[0]];
+
+                nx += (ay * bz) - (az * by);
+                ny += (az * bx) - (ax * bz);
+                nz += (ax * by) - (ay * bx);
+            }
+            nx /= num_faces;
+            ny /= num_faces;
+            nz /= num_faces;
+
+            // One-ring centroid
+            int valence = adjacency.valence(v);
+            const int *neighbours = adjacency.neighbours(v);
+            double qx = 0.0, qy = 0.0, qz = 0.0;
+            for (int j = 0; j < valence; ++j) {
+                qx += x[neighbours[j]];
+                qy += y[neighbours[j]];
+                qz += z[neighbours[j]];
+            }
+            qx /= (double) valence;
+            qy /= (double) valence;
+            qz /= (double) valence;
+
+            double d = nx * (x[v] - qx) + ny * (y[v] - qy) + nz * (z[v] - qz);
+            double rx = qx + d * nx, ry = qy + d * ny, rz = qz + d * nz;
+
+            if (factor == 1.0) {
+                x[v] = rx;
+                y[v] = ry;
+                z[v] = rz;
+            } else {
+                x[v] += factor * (rx - x[v]);
+                y[v] += factor * (ry - y[v]);
+                z[v] += factor * (rz - z[v]);
+            }
+        }
+    });
+}
+
+void
+SoAGeometry::scatter_arrays(
+    const Adjacency& adjacency,
+    const std::vector<double>& x,
+    const std::vector<double>& y,
+    const std::vector<double>& z,
+    int num_threads
+) const {
+    /**
+     * Writes x/y/z back into the vertices of adjacency
+     */
+    flux_assert((int) x.size() == adjacency.nb_vertices());
+
+    parallel_for(x.size(), num_threads, [&](int, int begin, int end) {
+        HalfVertex *vertex;
+        for (int v = begin; v < end; ++v) {
+            vertex = adjacency.vertex(v);
+            if (!vertex) continue;
+            vertex->point[0] = x[v];
+            vertex->point[1] = y[v];
+            vertex->point[2] = z[v];
+        }
+    });
+}
+
+} // flux
@@ -0,0 +1,65 @@
+#ifndef FLUX_REMESHER3D_GEOMETRY_H
+#define FLUX_REMESHER3D_GEOMETRY_H
+
+#include "adjacency.h"
+#include <vector>
+
+namespace flux {
+
+/**
+ * Structure-of-arrays snapshot of the vertex coordinates of a mesh, numbered
+ * like an Adjacency, together with batch kernels for tangential relaxation.
+ *
+ * Every kernel is a flat loop over separate x/y/z arrays (plus the CSR rows
+ * and triangle table of the Adjacency), written so the compiler can turn it
+ * into packed AVX2/NEON arithmetic. Results only reach the HalfEdgeMesh in
+ * scatter() (or scatter_points() after relax_in_place()).
+ */
+class SoAGeometry {
+public:
+
+void gather(const Adjacency& adjacency, int num_threads);
+void scatter(const Adjacency& adjacency, int num_threads) const;
+void scatter_points(const Adjacency& adjacency, int num_threads) const;
+
+/* Kernels */
+void compute_face_normals(const Adjacency& adjacency, int num_threads);
+void compute_vertex_normals(const Adjacency& adjacency, int num_threads);
+void compute_centroids(const Adjacency& adjacency, int num_threads);
+void compute_relaxed_points(double factor, int num_threads);
+void relax_in_place(
+    const Adjacency& adjacency,
+    const int *vertices,
+    int num_vertices,
+    double factor,
+    int num_threads
+);
+
+int nb_vertices() const { return _x.size(); }
+
+private:
+void scatter_arrays(
+    const Adjacency& adjacency,
+    const std::vector<double>& x,
+    const std::vector<double>& y,
+    const std::vector<double>& z,
+    int num_threads
+) const;
+
+// Vertex coordinates
+std::vector<double> _x, _y, _z;
+
+// Face normals (not normalized, as in Remesher3d::calculate_face_normal)
+std::vector<double> _face_nx, _face_ny, _face_nz;
+
+// Averaged one-ring face normals and one-ring centroids
+std::vector<double> _nx, _ny, _nz;
+std::vector<double> _qx, _qy, _qz;
+
+// Relaxed coordinates
+std::vector<double> _rx, _ry, _rz;
+};
+
+} // flux
+
+#endif
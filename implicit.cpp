@@ -0,0 +1,33 @@
+#include "implicit.h"
+
+namespace flux {
+
+void
+ImplicitFunction::evaluate(const double *points, int num_points, double *values) const {
+    for (int i = 0; i < num_points; ++i) {
+        values[i] = (*this)(points + 3 * i);
+    }
+}
+
+void
+ImplicitFunction::gradient(const double *points, int num_points, double *gradients) const {
+    /**
+     * Central differences, (f(x + h) - f(x - h)) / 2h along each axis
+     */
+    double x[3];
+    for (int i = 0; i < num_points; ++i) {
+        for (int d = 0; d < 3; ++d) x[d] = points[3 * i + d];
+
+        for (int d = 0; d < 3; ++d) {
+            x[d] = points[3 * i + d] + _step;
+            double forward = (*this)(x);
+            x[d] = points[3 * i + d] - _step;
+            double backward = (*this)(x);
+            x[d] = points[3 * i + d];
+
+            gradients[3 * i + d] = (forward - backward) / (2.0 * _step);
+        }
+    }
+}
+
+} // flux
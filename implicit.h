@@ -0,0 +1,95 @@
+#ifndef FLUX_REMESHER3D_IMPLICIT_H
+#define FLUX_REMESHER3D_IMPLICIT_H
+
+#include "vec.hpp"
+
+namespace flux {
+
+/**
+ * Scalar function whose zero level set is a surface to project onto.
+ *
+ * points holds xyz triples back to back. evaluate() fills one value per
+ * point and gradient() one xyz gradient per point. By default they loop over
+ * operator() and use central differences with step _step, functions with
+ * analytic gradients or vectorized evaluation override them. Both are called
+ * from several threads at once.
+ */
+class ImplicitFunction {
+public:
+
+ImplicitFunction(double step = 1e-6) : _step(step) {  }
+virtual ~ImplicitFunction() {  }
+
+virtual double operator()(const double *x) const = 0;
+virtual void evaluate(const double *points, int num_points, double *values) const;
+virtual void gradient(const double *points, int num_points, double *gradients) const;
+
+protected:
+double _step;
+};
+
+/**
+ * ImplicitFunction calling any function object that takes a vec3d and
+ * returns a double (a signed distance or other level-set function)
+ */
+template<typename Function>
+class ImplicitAdapter : public ImplicitFunction {
+public:
+
+ImplicitAdapter(Function& function, double step = 1e-6) :
+ImplicitFunction(step),
+_function(function)
+{  }
+
+double operator()(const double *x) const {
+    vec3d point;
+    for (int d = 0; d < 3; ++d) point[d] = x[d];
+    return _function(point);
+}
+
+private:
+Function& _function;
+};
+
+/**
+ * ImplicitFunction over a function object that takes a vec3d and returns
+ * the offset of that point from its closest surface point, as
+ * SphereTetFunction in marching-tets' tet-functions.h does (see
+ * correct_tangential_relaxation). The value is the unsigned distance |d| and
+ * the gradient d / |d|, so one Newton step lands on x - d.
+ */
+template<typename Function>
+class DisplacementAdapter : public ImplicitFunction {
+public:
+
+DisplacementAdapter(Function& function) :
+_function(function)
+{  }
+
+double operator()(const double *x) const {
+    return norm(displacement(x));
+}
+
+void gradient(const double *points, int num_points, double *gradients) const {
+    for (int i = 0; i < num_points; ++i) {
+        vec3d offset = displacement(points + 3 * i);
+        double length = norm(offset);
+        for (int d = 0; d < 3; ++d) {
+            gradients[3 * i + d] = (length > 0.0) ? offset[d] / length : 0.0;
+        }
+    }
+}
+
+private:
+Function& _function;
+
+vec3d displacement(const double *x) const {
+    vec3d point;
+    for (int d = 0; d < 3; ++d) point[d] = x[d];
+    return _function(point);
+}
+};
+
+} // flux
+
+#endif
@@ -1,25 +1,215 @@
 #include "remesher3d.h"
+#include "batch.h"
+#include "builder.h"
+#include "meshfile.h"
+#include "parallel.h"
 #include "mesh.h"
 #include "grid.h"
 #include "element.h"
 #include "webgl.h"
 #include "sphere.h"
 #include "./sizing-fields/edgelengthsizingfield.h"
+#include "./sizing-fields/gridsizingfield.h"
 
 #include "../marching-tets/marchingtet.h"
 #include "../marching-tets/tet-functions.h"
 
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+
 using namespace flux;
 
+template<typename Field>
+void
+remesh_file(
+    HalfEdgeMesh<Triangle>& halfmesh,
+    Field& field,
+    int num_iterations,
+    int num_threads,
+    const std::string& checkpoint
+) {
+    BasicRemesher3d<Field> remesh(halfmesh, field);
+    remesh.set_num_threads(num_threads);
+
+    // An interrupted run with the same checkpoint is picked up where it stopped
+    if (!checkpoint.empty()) {
+        if (remesh.resume(checkpoint)) std::cout << "Resuming " << checkpoint << std::endl;
+        remesh.set_checkpoint(checkpoint, 1);
+    }
+    remesh.incremental_relaxation(num_iterations);
+    remesh.print_stats();
+}
+
+int
+run_batch(int argc, char *argv[]) {
+    /**
+     * Remeshes the mesh file argv[1] into the mesh file argv[2] without
+     * prompts or viewer. argv[3] is either a target edge length or a grid
+     * written by GridSizingField::save, argv[4] the maximum number of
+     * incremental_relaxation passes, argv[5] (optional) the number of
+     * threads, every hardware thread by default, and argv[6] (optional) a
+     * checkpoint written after every pass and resumed from if it exists
+     *
+     * RETURNS: exit status, 0 on success
+     */
+    std::string input = argv[1], output = argv[2];
+    int num_iterations = atoi(argv[4]);
+    int num_threads = (argc > 5) ? atoi(argv[5]) : 0;
+    if (num_threads < 1) num_threads = hardware_threads();
+    std::string checkpoint = (argc > 6) ? argv[6] : "";
+
+    Mesh<Triangle> no_triangles(3);
+    HalfEdgeMesh<Triangle> halfmesh(no_triangles);
+    if (!load_mesh(input, halfmesh, num_threads)) {
+        std::cerr << "Could not read a manifold mesh from " << input << std::endl;
+        return 1;
+    }
+
+    // A number is a constant target length, anything else a sizing grid
+    char *end;
+    double length = strtod(argv[3], &end);
+    if (*end == '\0' && length > 0.0) {
+        EdgelengthSizingField field(length);
+        remesh_file(halfmesh, field, num_iterations, num_threads, checkpoint);
+    } else {
+        GridSizingField field;
+        if (!field.load(argv[3])) {
+            std::cerr << "Could not read a sizing grid from " << argv[3] << std::endl;
+            return 1;
+        }
+        remesh_file(halfmesh, field, num_iterations, num_threads, checkpoint);
+    }
+
+    if (!save_mesh(output, halfmesh, num_threads)) {
+        std::cerr << "Could not write " << output << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int
+run_list(int argc, char *argv[]) {
+    /**
+     * Remeshes every mesh listed in the file argv[2] with remesh_batch, on
+     * argv[3] (optional) threads, every hardware thread by default. Each
+     * line reads "input output length|grid iterations" as in run_batch.
+     * Grids named on several lines are loaded once and shared
+     *
+     * RETURNS: exit status, 0 if every mesh was read, remeshed and written
+     */
+    int num_threads = (argc > 3) ? atoi(argv[3]) : 0;
+    if (num_threads < 1) num_threads = hardware_threads();
+
+    std::ifstream list(argv[2]);
+    if (!list) {
+        std::cerr << "Could not read " << argv[2] << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> inputs, outputs;
+    std::vector<std::unique_ptr<HalfEdgeMesh<Triangle>>> halfmeshes;
+    std::vector<RemeshTask> tasks;
+    std::vector<std::unique_ptr<SizingField<3>>> lengths;
+    std::map<std::string, std::unique_ptr<GridSizingField>> grids;
+    Mesh<Triangle> no_triangles(3);
+
+    std::string line;
+    while (std::getline(list, line)) {
+        std::istringstream words(line);
+        std::string input, output, field;
+        int num_iterations;
+        if (!(words >> input >> output >> field >> num_iterations)) continue;
+
+        // A number is a constant target length, anything else a sizing grid
+        RemeshTask task;
+        char *end;
+        double length = strtod(field.c_str(), &end);
+        if (*end == '\0' && length > 0.0) {
+            lengths.emplace_back(new EdgelengthSizingField(length));
+            task.sizing_field = lengths.back().get();
+        } else {
+            std::unique_ptr<GridSizingField>& grid = grids[field];
+            if (!grid) {
+                grid.reset(new GridSizingField);
+                if (!grid->load(field)) {
+                    std::cerr << "Could not read a sizing grid from " << field << std::endl;
+                    return 1;
+                }
+            }
+            task.sizing_field = grid.get();
+        }
+
+        halfmeshes.emplace_back(new HalfEdgeMesh<Triangle>(no_triangles));
+        task.halfmesh = halfmeshes.back().get();
+        task.num_iterations = num_iterations;
+        tasks.push_back(task);
+        inputs.push_back(input);
+        outputs.push_back(output);
+    }
+
+    // Meshes are loaded and written in parallel too, one per thread at a time
+    int num_tasks = tasks.size();
+    std::vector<char> loaded(num_tasks), saved(num_tasks);
+    parallel_for(num_tasks, num_threads, [&](int, int begin, int end) {
+        for (int i = begin; i < end; ++i) loaded[i] = load_mesh(inputs[i], *halfmeshes[i], 1);
+    });
+
+    std::vector<RemeshTask> valid_tasks;
+    for (int i = 0; i < num_tasks; ++i) {
+        if (loaded[i]) valid_tasks.push_back(tasks[i]);
+    }
+    std::vector<RemeshResult> results = remesh_batch(valid_tasks, num_threads);
+
+    parallel_for(num_tasks, num_threads, [&](int, int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            saved[i] = loaded[i] && save_mesh(outputs[i], *halfmeshes[i], 1);
+        }
+    });
+
+    int status = 0;
+    for (int i = 0, r = 0; i < num_tasks; ++i) {
+        if (!loaded[i]) {
+            std::cerr << "Could not read a manifold mesh from " << inputs[i] << std::endl;
+            status = 1;
+            continue;
+        }
+        const RemeshResult& result = results[r++];
+        std::cout << outputs[i] << ": " << result.reports.size() << " passes, "
+            << result.num_vertices << " vertices, " << result.num_faces << " faces, "
+            << result.seconds << " s on thread " << result.thread << std::endl;
+        if (!saved[i]) {
+            std::cerr << "Could not write " << outputs[i] << std::endl;
+            status = 1;
+        }
+    }
+    return status;
+}
+
 int
 main (int argc, char *argv[]) {
+    // remesher3d_exe --batch list [threads]
+    if (argc >= 3 && std::string(argv[1]) == "--batch") return run_list(argc, argv);
+
+    // remesher3d_exe input output length|grid iterations [threads [checkpoint]]
+    if (argc >= 5) return run_batch(argc, argv);
+
     /* Creating un-uniform sphere from marching-tet project */
     // Creating analytical sphere function
     Sphere<Triangle> sphere(10,10,.3);
     EdgelengthSizingField function(0.06);
 
-    HalfEdgeMesh<Triangle> halfmesh(sphere);
-    Remesher3d remesh(halfmesh, function);
+    // Twins are matched by the parallel builder rather than HalfEdgeMesh(sphere)
+    Mesh<Triangle> no_triangles(3);
+    HalfEdgeMesh<Triangle> halfmesh(no_triangles);
+    if (!build_halfmesh(sphere, halfmesh, hardware_threads())) {
+        std::cout << "Sphere is not a manifold surface" << std::endl;
+        return 1;
+    }
+    BasicRemesher3d<EdgelengthSizingField> remesh(halfmesh, function);
     remesh.incremental_relaxation(10);
 
     remesh.run_viewer();
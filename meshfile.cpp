@@ -0,0 +1,199 @@
+#include "meshfile.h"
+#include "builder.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace flux {
+
+namespace {
+
+// Identifies files written by save_mesh
+const char MESH_MAGIC[8] = {'R', '3', 'D', 'M', 'E', 'S', 'H', '1'};
+
+struct MeshHeader {
+    char magic[8];
+    int32_t num_vertices;
+    int32_t num_triangles;
+};
+
+static_assert(sizeof(MeshHeader) == 16, "points must start 8-byte aligned");
+static_assert(sizeof(int32_t) == sizeof(int), "triangles are passed to build_halfmesh as int");
+
+size_t
+file_size(int32_t num_vertices, int32_t num_triangles) {
+    return sizeof(MeshHeader) + 3 * sizeof(double) * (size_t) num_vertices
+        + 3 * sizeof(int32_t) * (size_t) num_triangles;
+}
+
+bool
+write_all(int fd, const void *data, size_t size) {
+    /**
+     * write() until all of data is out, so a full disk is an error here
+     * rather than a short file
+     */
+    const char *bytes = (const char*) data;
+    while (size > 0) {
+        ssize_t written = ::write(fd, bytes, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        bytes += written;
+        size -= written;
+    }
+    return true;
+}
+
+} // namespace
+
+MeshFile::MeshFile() :
+_data(nullptr),
+_size(0)
+{  }
+
+MeshFile::~MeshFile() {
+    close();
+}
+
+bool
+MeshFile::open(const std::string& filename) {
+    /**
+     * Maps filename read-only, replacing any file mapped before
+     *
+     * RETURNS: false if the file is missing, not a mesh file or truncated
+     */
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || (size_t) status.st_size < sizeof(MeshHeader)) {
+        ::close(fd);
+        return false;
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    void *data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) return false;
+
+    _data = data;
+    _size = status.st_size;
+
+    const MeshHeader *header = (const MeshHeader*) _data;
+    if (!std::equal(header->magic, header->magic + sizeof(MESH_MAGIC), MESH_MAGIC)
+        || header->num_vertices < 0 || header->num_triangles < 0
+        || file_size(header->num_vertices, header->num_triangles) != _size) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void
+MeshFile::close() {
+    if (_data) munmap(_data, _size);
+    _data = nullptr;
+    _size = 0;
+}
+
+int
+MeshFile::nb_vertices() const {
+    return _data ? ((const MeshHeader*) _data)->num_vertices : 0;
+}
+
+int
+MeshFile::nb_triangles() const {
+    return _data ? ((const MeshHeader*) _data)->num_triangles : 0;
+}
+
+const double*
+MeshFile::points() const {
+    if (!_data) return nullptr;
+    return (const double*) ((const char*) _data + sizeof(MeshHeader));
+}
+
+const int32_t*
+MeshFile::triangles() const {
+    if (!_data) return nullptr;
+    return (const int32_t*) (points() + 3 * (size_t) nb_vertices());
+}
+
+bool
+load_mesh(const std::string& filename, HalfEdgeMesh<Triangle>& halfmesh, int num_threads) {
+    /**
+     * Builds halfmesh straight from the mapped arrays of filename. The file
+     * is unmapped again before returning, so it may be overwritten later
+     *
+     * RETURNS: false if the file cannot be read or is not a manifold mesh
+     */
+    MeshFile file;
+    if (!file.open(filename)) return false;
+
+    return build_halfmesh(file.points(), file.nb_vertices(), file.triangles(),
+        file.nb_triangles(), halfmesh, num_threads);
+}
+
+bool
+save_mesh(const std::string& filename, const HalfEdgeMesh<Triangle>& halfmesh, int num_threads) {
+    /**
+     * Writes the live vertices (in container order) and faces of halfmesh,
+     * replacing filename
+     *
+     * RETURNS: false if the file could not be written
+     */
+    std::vector<double> points;
+    std::vector<int> triangles;
+    extract_halfmesh(halfmesh, points, triangles, num_threads);
+    return save_mesh(filename, points.data(), points.size() / 3, triangles.data(),
+        triangles.size() / 3);
+}
+
+bool
+save_mesh(
+    const std::string& filename,
+    const double *points,
+    int num_vertices,
+    const int *triangles,
+    int num_triangles
+) {
+    /**
+     * Writes points (xyz triples) and triangles (three vertex ids each) to a
+     * temporary file next to filename, flushes it to disk and renames it over
+     * filename, so filename is either the old file or the complete new one.
+     * Plain write() calls rather than a writable mapping: running out of space
+     * is reported here instead of raising SIGBUS on a page of the mapping
+     *
+     * RETURNS: false if the file could not be written
+     */
+    std::string temporary = filename + ".tmp";
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+
+    MeshHeader header;
+    std::memcpy(header.magic, MESH_MAGIC, sizeof(MESH_MAGIC));
+    header.num_vertices = num_vertices;
+    header.num_triangles = num_triangles;
+
+    bool written = write_all(fd, &header, sizeof(header))
+        && write_all(fd, points, 3 * sizeof(double) * (size_t) num_vertices)
+        && write_all(fd, triangles, 3 * sizeof(int32_t) * (size_t) num_triangles)
+        && fsync(fd) == 0;
+    written = (::close(fd) == 0) && written;
+
+    if (!written || std::rename(temporary.c_str(), filename.c_str()) != 0) {
+        unlink(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+} // flux
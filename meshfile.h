@@ -0,0 +1,57 @@
+#ifndef FLUX_REMESHER3D_MESHFILE_H
+#define FLUX_REMESHER3D_MESHFILE_H
+
+#include "halfedges.h"
+#include "element.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace flux {
+
+/**
+ * Binary mesh file, in native byte order: a 16-byte header (magic
+ * "R3DMESH1", then the vertex and triangle counts as int32), the xyz doubles
+ * of every vertex and three int32 vertex ids per triangle. Both arrays start
+ * 8-byte aligned, so a mapped file is read in place.
+ *
+ * MeshFile maps a file read-only. points() and triangles() point into the
+ * mapping and go straight to build_halfmesh(), without parsing or copying
+ * the file. save_mesh() writes the arrays (given, or extracted from a
+ * HalfEdgeMesh) to a temporary file that replaces the old one once it is
+ * complete and on disk.
+ */
+class MeshFile {
+public:
+
+MeshFile();
+~MeshFile();
+MeshFile(const MeshFile&) = delete;
+MeshFile& operator=(const MeshFile&) = delete;
+
+bool open(const std::string& filename);
+void close();
+
+int nb_vertices() const;
+int nb_triangles() const;
+const double* points() const;
+const int32_t* triangles() const;
+
+private:
+void *_data;
+size_t _size;
+};
+
+bool load_mesh(const std::string& filename, HalfEdgeMesh<Triangle>& halfmesh, int num_threads);
+bool save_mesh(const std::string& filename, const HalfEdgeMesh<Triangle>& halfmesh, int num_threads);
+bool save_mesh(
+    const std::string& filename,
+    const double *points,
+    int num_vertices,
+    const int *triangles,
+    int num_triangles
+);
+
+} // flux
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef FLUX_REMESHER3D_PARALLEL_H
+#define FLUX_REMESHER3D_PARALLEL_H
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace flux {
+
+inline int
+hardware_threads() {
+    /**
+     * Number of threads the machine can run concurrently (at least 1)
+     */
+    int num_threads = std::thread::hardware_concurrency();
+    return (num_threads > 0) ? num_threads : 1;
+}
+
+template<typename Function>
+void
+parallel_for(int num_items, int num_threads, Function function) {
+    /**
+     * Splits [0, num_items) into contiguous chunks, one per thread, and calls
+     * function(thread, begin, end) on each chunk. With one thread (or too few
+     * items to be worth it) the function runs on the calling thread
+     *
+     * PARAMS:
+     * num_items:   number of items to distribute
+     * num_threads: number of threads to use (values < 1 mean 1)
+     * function:    callable taking (int thread, int begin, int end)
+     */
+    if (num_items <= 0) return;
+    num_threads = std::max(1, std::min(num_threads, num_items));
+
+    if (num_threads == 1) {
+        function(0, 0, num_items);
+        return;
+    }
+
+    int chunk = (num_items + num_threads - 1) / num_threads;
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1);
+
+    for (int t = 1; t < num_threads; ++t) {
+        int begin = t * chunk;
+        int end = std::min(num_items, begin + chunk);
+        if (begin >= end) break;
+        threads.emplace_back(function, t, begin, end);
+    }
+
+    // Calling thread takes the first chunk
+    function(0, 0, std::min(num_items, chunk));
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+} // flux
+
+#endif
@@ -0,0 +1,137 @@
+#include "pool.h"
+#include "tombstone.h"
+
+namespace flux {
+
+ElementPool::ElementPool(HalfEdgeMesh<Triangle>& halfmesh) :
+_halfmesh(halfmesh)
+{  }
+
+HalfVertex*
+ElementPool::create_vertex(const double *point) {
+    /**
+     * Returns a live, unconnected vertex at point
+     */
+    if (_free_vertices.empty()) grow_vertices(CHUNK_SIZE);
+
+    HalfVertex *vertex = _free_vertices.back();
+    _free_vertices.pop_back();
+
+    for (int i = 0; i < 3; ++i) {
+        vertex->point[i] = point[i];
+    }
+    vertex->edge = nullptr;
+    vertex->index = 0;
+    return vertex;
+}
+
+HalfEdge*
+ElementPool::create_edge() {
+    /**
+     * Returns an unconnected halfedge. It counts as dead until its vertex is set
+     */
+    if (_free_edges.empty()) grow_edges(CHUNK_SIZE);
+
+    HalfEdge *halfedge = _free_edges.back();
+    _free_edges.pop_back();
+    halfedge->prev = nullptr;
+    return halfedge;
+}
+
+HalfFace*
+ElementPool::create_face() {
+    /**
+     * Returns an unconnected face. It counts as dead until its edge is set
+     */
+    if (_free_faces.empty()) grow_faces(CHUNK_SIZE);
+
+    HalfFace *face = _free_faces.back();
+    _free_faces.pop_back();
+    return face;
+}
+
+void
+ElementPool::release(HalfVertex *vertex) {
+    /**
+     * Marks vertex dead and keeps it for the next create_vertex()
+     */
+    kill(vertex);
+    _free_vertices.push_back(vertex);
+}
+
+void
+ElementPool::release(HalfEdge *halfedge) {
+    kill(halfedge);
+    _free_edges.push_back(halfedge);
+}
+
+void
+ElementPool::release(HalfFace *face) {
+    kill(face);
+    _free_faces.push_back(face);
+}
+
+void
+ElementPool::reserve(int num_vertices, int num_edges, int num_faces) {
+    /**
+     * Makes sure the next num_vertices/num_edges/num_faces creations are
+     * served from the free lists
+     */
+    int size;
+    if ((size = nb_free_vertices()) < num_vertices) grow_vertices(num_vertices - size);
+    if ((size = nb_free_edges()) < num_edges) grow_edges(num_edges - size);
+    if ((size = nb_free_faces()) < num_faces) grow_faces(num_faces - size);
+}
+
+int
+ElementPool::trim() {
+    /**
+     * Erases every unused element from the mesh and empties the free lists
+     *
+     * RETURNS: number of erased elements
+     */
+    _free_vertices.clear();
+    _free_edges.clear();
+    _free_faces.clear();
+    return erase_dead(_halfmesh);
+}
+
+void
+ElementPool::grow_vertices(int num_vertices) {
+    /**
+     * Creates num_vertices dead vertices. They are pushed in reverse so they
+     * are handed out in creation order
+     */
+    const double origin[3] = { 0.0, 0.0, 0.0 };
+    int size = _free_vertices.size();
+    _free_vertices.resize(size + num_vertices);
+    for (int i = num_vertices - 1; i >= 0; --i) {
+        HalfVertex *vertex = _halfmesh.create_vertex(3, origin);
+        kill(vertex);
+        _free_vertices[size + i] = vertex;
+    }
+}
+
+void
+ElementPool::grow_edges(int num_edges) {
+    int size = _free_edges.size();
+    _free_edges.resize(size + num_edges);
+    for (int i = num_edges - 1; i >= 0; --i) {
+        HalfEdge *halfedge = _halfmesh.create_edge();
+        kill(halfedge);
+        _free_edges[size + i] = halfedge;
+    }
+}
+
+void
+ElementPool::grow_faces(int num_faces) {
+    int size = _free_faces.size();
+    _free_faces.resize(size + num_faces);
+    for (int i = num_faces - 1; i >= 0; --i) {
+        HalfFace *face = _halfmesh.create_face();
+        kill(face);
+        _free_faces[size + i] = face;
+    }
+}
+
+} // flux
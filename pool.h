@@ -0,0 +1,67 @@
+#ifndef FLUX_REMESHER3D_POOL_H
+#define FLUX_REMESHER3D_POOL_H
+
+#include "halfedges.h"
+#include "element.h"
+#include <vector>
+
+namespace flux {
+
+/**
+ * Free lists of recycled HalfEdgeMesh elements. This is only a free list,
+ * not an arena.
+ *
+ * It cannot be an arena because HalfEdgeMesh keeps every element in a
+ * std::unique_ptr and deletes it one at a time, so each element has to be
+ * its own heap allocation; one carved out of a shared block would be freed
+ * twice. Released elements are therefore not deleted: they are tombstoned
+ * (see tombstone.h) and stay in the mesh containers until a split asks for
+ * a new one. The saving is the reuse, not the allocation: when a list runs
+ * dry, a chunk of elements is still created one create_* call at a time,
+ * and nothing makes them contiguous.
+ *
+ * What it costs:
+ * - dead entries stay in the containers, and every loop over them skips
+ *   them, until trim() erases the unused ones once remeshing is done;
+ * - reorder_mesh() may not recreate elements in Morton order (relocate)
+ *   while the lists point at dead ones, so with a pool only the order of
+ *   the containers improves, not the placement of the elements in memory.
+ */
+class ElementPool {
+public:
+
+ElementPool(HalfEdgeMesh<Triangle>& halfmesh);
+
+HalfVertex* create_vertex(const double *point);
+HalfEdge* create_edge();
+HalfFace* create_face();
+
+void release(HalfVertex *vertex);
+void release(HalfEdge *halfedge);
+void release(HalfFace *face);
+
+void reserve(int num_vertices, int num_edges, int num_faces);
+int trim();
+
+int nb_free_vertices() const { return _free_vertices.size(); }
+int nb_free_edges() const { return _free_edges.size(); }
+int nb_free_faces() const { return _free_faces.size(); }
+
+private:
+HalfEdgeMesh<Triangle>& _halfmesh;
+
+std::vector<HalfVertex*> _free_vertices;
+std::vector<HalfEdge*> _free_edges;
+std::vector<HalfFace*> _free_faces;
+
+// Number of elements added to a free list when it is empty
+static const int CHUNK_SIZE = 256;
+
+void grow_vertices(int num_vertices);
+void grow_edges(int num_edges);
+void grow_faces(int num_faces);
+};
+
+} // flux
+
+#endif
@@ -0,0 +1,190 @@
+#include "remesher3d.h"
+#include "builder.h"
+#include "checkpoint.h"
+#include "meshfile.h"
+#include "parallel.h"
+#include "tombstone.h"
+#include "mesh.h"
+#include "element.h"
+#include "sphere.h"
+#include "./sizing-fields/edgelengthsizingfield.h"
+
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using namespace flux;
+
+namespace {
+
+int num_failures = 0;
+
+void
+expect(bool condition, const std::string& what) {
+    /**
+     * Reports one check, counting it if it failed
+     */
+    std::cout << (condition ? "PASS " : "FAIL ") << what << std::endl;
+    if (!condition) num_failures++;
+}
+
+bool
+is_closed_manifold(const HalfEdgeMesh<Triangle>& halfmesh, int& num_vertices, int& num_faces) {
+    /**
+     * Checks the connectivity of every live element: twins pair up, faces are
+     * closed loops of three halfedges, vertices and faces point at halfedges
+     * that belong to them, no halfedge is on the boundary, and the Euler
+     * characteristic is the one of a sphere
+     *
+     * RETURNS: false on the first broken link
+     */
+    num_vertices = num_faces = 0;
+    int num_halfedges = 0;
+
+    for (auto& v : halfmesh.vertices()) {
+        if (is_dead(v.get())) continue;
+        if (!v->edge || is_dead(v->edge) || v->edge->vertex != v.get()) return false;
+        num_vertices++;
+    }
+    for (auto& e : halfmesh.edges()) {
+        if (is_dead(e.get())) continue;
+        if (!e->face || !e->twin || e->twin->twin != e.get()) return false;
+        if (e->twin->vertex != e->next->vertex) return false;
+        if (e->next->next->next != e.get() || e->next->face != e->face) return false;
+        num_halfedges++;
+    }
+    for (auto& f : halfmesh.faces()) {
+        if (is_dead(f.get())) continue;
+        if (f->edge->face != f.get()) return false;
+        num_faces++;
+    }
+
+    return num_halfedges == 3 * num_faces
+        && num_vertices - num_halfedges / 2 + num_faces == 2;
+}
+
+bool
+build_sphere(HalfEdgeMesh<Triangle>& halfmesh) {
+    /**
+     * Same input as main(): the marching-tets sphere
+     */
+    Sphere<Triangle> sphere(10, 10, .3);
+    return build_halfmesh(sphere, halfmesh, hardware_threads());
+}
+
+void
+check_core(bool compact_core, int& num_vertices) {
+    /**
+     * Remeshes the sphere through one core and checks the result
+     */
+    std::string core = compact_core ? "compact core" : "pointer core";
+    Mesh<Triangle> no_triangles(3);
+    HalfEdgeMesh<Triangle> halfmesh(no_triangles);
+    expect(build_sphere(halfmesh), core + ": sphere builds");
+
+    EdgelengthSizingField field(0.06);
+    BasicRemesher3d<EdgelengthSizingField> remesh(halfmesh, field);
+    remesh.set_verbose(false);
+    remesh.set_compact_core(compact_core);
+    std::vector<IterationReport> reports = remesh.incremental_relaxation(10);
+
+    int num_faces;
+    expect(is_closed_manifold(halfmesh, num_vertices, num_faces), core + ": closed manifold");
+    expect(num_faces == 2 * num_vertices - 4, core + ": F = 2V - 4");
+    expect(!reports.empty() && reports.back().median_ratio > sqrt(2) / 2.0
+        && reports.back().median_ratio < sqrt(2), core + ": median length/target within bounds");
+}
+
+void
+check_checkpoint_round_trip() {
+    /**
+     * save_checkpoint() then load_checkpoint() gives back the same arrays,
+     * and a truncated file is rejected
+     */
+    Mesh<Triangle> no_triangles(3);
+    HalfEdgeMesh<Triangle> halfmesh(no_triangles);
+    build_sphere(halfmesh);
+
+    Checkpoint saved;
+    extract_halfmesh(halfmesh, saved.points, saved.triangles, hardware_threads());
+    saved.reports.resize(2);
+    saved.reports[0].num_splits = 3;
+    saved.reports[1].median_ratio = 0.5;
+    saved.reference = std::vector<double>(saved.points.begin(), saved.points.begin() + 9);
+
+    std::string filename = "regression.ckpt";
+    expect(save_checkpoint(filename, saved), "checkpoint: saved");
+
+    Checkpoint loaded;
+    expect(load_checkpoint(filename, loaded), "checkpoint: loaded");
+    expect(loaded.points == saved.points && loaded.triangles == saved.triangles
+        && loaded.reference == saved.reference, "checkpoint: same arrays");
+    expect(loaded.reports.size() == 2 && loaded.reports[0].num_splits == 3
+        && loaded.reports[1].median_ratio == 0.5, "checkpoint: same reports");
+
+    // The last triangle cut off
+    FILE *file = fopen(filename.c_str(), "r+b");
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    expect(truncate(filename.c_str(), size - 12) == 0
+        && !load_checkpoint(filename, loaded), "checkpoint: truncated file rejected");
+    std::remove(filename.c_str());
+}
+
+void
+check_mesh_file_round_trip() {
+    /**
+     * save_mesh() then load_mesh() gives back the same vertices and triangles
+     * as a closed manifold, and a missing file is rejected
+     */
+    Mesh<Triangle> no_triangles(3);
+    HalfEdgeMesh<Triangle> halfmesh(no_triangles);
+    build_sphere(halfmesh);
+
+    std::string filename = "regression.mesh";
+    expect(save_mesh(filename, halfmesh, hardware_threads()), "mesh file: saved");
+
+    HalfEdgeMesh<Triangle> loaded(no_triangles);
+    expect(load_mesh(filename, loaded, hardware_threads()), "mesh file: loaded");
+
+    std::vector<double> points, loaded_points;
+    std::vector<int> triangles, loaded_triangles;
+    extract_halfmesh(halfmesh, points, triangles, hardware_threads());
+    extract_halfmesh(loaded, loaded_points, loaded_triangles, hardware_threads());
+    expect(points == loaded_points && triangles == loaded_triangles, "mesh file: same arrays");
+
+    int num_vertices, num_faces;
+    expect(is_closed_manifold(loaded, num_vertices, num_faces), "mesh file: closed manifold");
+
+    std::remove(filename.c_str());
+    expect(!load_mesh(filename, loaded, hardware_threads()), "mesh file: missing file rejected");
+}
+
+} // namespace
+
+int
+main() {
+    /**
+     * Regression checks of the remesher, meant to be run after every change:
+     * both cores on the sphere of main(), checkpoint and mesh file round trips
+     *
+     * RETURNS: number of failed checks
+     */
+    int pointer_vertices = 0, compact_vertices = 0;
+    check_core(false, pointer_vertices);
+    check_core(true, compact_vertices);
+
+    // The cores apply the same tests in a different order, so counts differ a little
+    expect(4 * compact_vertices > 3 * pointer_vertices && 4 * pointer_vertices > 3 * compact_vertices,
+        "cores: vertex counts within 25% of each other");
+
+    check_checkpoint_round_trip();
+    check_mesh_file_round_trip();
+
+    std::cout << num_failures << " failed" << std::endl;
+    return num_failures;
+}
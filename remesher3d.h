@@ -2,6 +2,18 @@
 #define FLUX_REMESHER3D_H
 
 #include "halfedges.h"
+#include "adjacency.h"
+#include "geometry.h"
+#include "edgequeue.h"
+#include "tombstone.h"
+#include "pool.h"
+#include "surface.h"
+#include "implicit.h"
+#include "reorder.h"
+#include "compactmesh.h"
+#include "checkpoint.h"
+#include "snapshot.h"
+#include "./sizing-fields/batchsizingfield.h"
 #include "element.h"
 #include "../marching-tets/tet-functions.h"
 #include "kdtree.h"
@@ -10,18 +22,81 @@
 
 namespace flux {
 
-class Remesher3d {
+/**
+ * Buffers a remesher grows while it runs. Remeshers built one after another
+ * (e.g. by one remesh_batch worker) hand the same RemesherScratch on through
+ * swap_scratch(), so later meshes reuse the allocations of earlier ones.
+ */
+struct RemesherScratch {
+    std::vector<double> midpoints;
+    std::vector<double> targets;
+    std::vector<HalfEdge*> halfedge_vector;
+    std::vector<HalfEdge*> edge_onering;
+    std::vector<int> touched_vertices;
+    std::vector<int> onering_scratch;
+    SoAGeometry geometry;
+    CompactMesh compact;
+    std::vector<CompactMesh::index_t> compact_ring;
+    std::vector<CompactMesh::index_t> compact_other_ring;
+};
+
+/**
+ * Remesher over a sizing field of type Field.
+ *
+ * Field is called directly, so with a final field whose operator() is
+ * defined in its header (GridSizingField) the target lengths in
+ * check_split/check_collapse are inlined instead of going through
+ * SizingField<3>'s virtual operator(). Constant fields skip the query
+ * altogether. Remesher3d keeps taking any SizingField<3> at runtime. The
+ * members are defined in remesher3d.tpp, so other Field types instantiate
+ * on use; the three common ones are compiled once in remesher3d.cpp.
+ *
+ * With more than one thread (see set_num_threads) the parallel stages call
+ * the field from several threads at once, so its operator() (and evaluate()
+ * for a BatchSizingField) must be safe to call concurrently: no caches or
+ * counters updated without a lock. Run a field that is not with one thread.
+ */
+template<typename Field>
+class BasicRemesher3d {
 public:
 
-Remesher3d(HalfEdgeMesh<Triangle>& halfmesh, SizingField<3>& sizing_field);
+BasicRemesher3d(HalfEdgeMesh<Triangle>& halfmesh, Field& sizing_field);
 
 /* Remeshing Algorithms: */
 void tangential_relaxation(int num_iterations);
-void incremental_relaxation(int num_iterations);
+std::vector<IterationReport> incremental_relaxation(int num_iterations);
+
 
+/* Settings */
+void set_num_threads(int num_threads);
+void set_priority_scheduling(bool enabled);
+void set_parallel_split(bool enabled);
+void set_parallel_collapse(bool enabled);
+void set_parallel_flip(bool enabled);
+void set_element_pool(bool enabled);
+void set_deferred_deletion(bool enabled);
+void set_active_set(bool enabled);
+void set_convergence_tolerance(double tolerance);
+void set_ratio_report(bool enabled);
+void set_projection(bool enabled);
+void set_normal_flip_check(bool enabled);
+void set_gauss_seidel(bool enabled);
+void set_relaxation_factor(double factor);
+void set_reorder_churn(double churn);
+void set_compact_core(bool enabled);
+void set_checkpoint(const std::string& filename, int interval);
+bool resume(const std::string& filename);
+void set_snapshots(const std::string& prefix, const std::string& extension);
+void set_verbose(bool enabled);
+void swap_scratch(RemesherScratch& scratch);
 
 /* Expeirmental Functions */
 void correct_tangential_relaxation(SphereTetFunction& function);
+int project_to_implicit(
+    const ImplicitFunction& function,
+    double tolerance,
+    int max_iterations
+);
 
 /* Statistics and Visual Functions */
 void print_stats();
@@ -31,20 +106,93 @@ HalfEdgeMesh<Triangle>& get_mesh();
 
 private:
 HalfEdgeMesh<Triangle>& _halfmesh;
-const SizingField<3>& _sizing_field;
+const Field& _sizing_field;
+const BatchSizingField* _batch_sizing_field;
+bool _constant_size;
+double _constant_target;
+std::vector<double> _midpoints;
+std::vector<double> _targets;
 std::vector<HalfEdge*> _halfedge_vector;
+std::vector<HalfEdge*> _edge_onering;
+Adjacency _adjacency;
+SoAGeometry _geometry;
+std::vector<int> _touched_vertices;
+std::vector<int> _onering_scratch;
+std::vector<char> _active_vertices;
+std::vector<char> _changed_vertices;
+
+int _num_threads;
+bool _verbose;
+bool _priority_scheduling;
+bool _parallel_collapse;
+bool _parallel_split;
+bool _parallel_flip;
+bool _element_pool;
+bool _deferred_deletion;
+bool _active_set;
+double _convergence_tolerance;
+bool _ratio_report;
+bool _projection;
+bool _normal_flip_check;
+bool _gauss_seidel;
+double _relaxation_factor;
+double _reorder_churn;
+int _churn;
+bool _compact_core;
+CompactMesh _compact;
+std::vector<CompactMesh::index_t> _compact_ring;
+std::vector<CompactMesh::index_t> _compact_other_ring;
+std::string _checkpoint_file;
+int _checkpoint_interval;
+Checkpoint _checkpoint;
+CheckpointWriter _checkpoint_writer;
+std::string _snapshot_prefix;
+std::string _snapshot_extension;
+int _num_snapshots;
+Snapshot _snapshot;
+SnapshotWriter _snapshot_writer;
+std::vector<IterationReport> _resumed_reports;
+std::vector<int> _color_offsets;
+std::vector<int> _colored_vertices;
+ReferenceSurface _reference;
+ElementPool _pool;
+EdgeQueue _split_queue;
+EdgeQueue _collapse_queue;
 
 /**
  * INCREMENTAL RELAXATION
  */
 void build();
+void compact();
+void reorder(std::vector<HalfVertex*>& tracked);
+void activate(std::vector<HalfVertex*>& changed);
+void checkpoint(const std::vector<IterationReport>& reports);
+void snapshot();
+void finish_snapshots();
+void measure_ratios(IterationReport& report);
+bool has_converged(const IterationReport& report);
 
 /**
  * SPLIT
  */
 std::pair<int,int> split_edges();
+std::pair<int,int> split_edges_by_priority();
+std::pair<int,int> split_edges_in_parallel();
+void queue_split(HalfEdge *halfedge);
 void split(HalfEdge *halfedge);
+void rewire_split(
+    HalfEdge *halfedge,
+    HalfVertex *new_vertex,
+    HalfEdge *edges[6],
+    HalfFace *faces[2]
+);
 void split_boundary(HalfEdge *halfedge);
+void rewire_split_boundary(
+    HalfEdge *halfedge,
+    HalfVertex *new_vertex,
+    HalfEdge *edges[4],
+    HalfFace *face
+);
 void change_edge(
     HalfEdge *halfedge,
     HalfEdge *next,
@@ -54,13 +202,21 @@ void change_edge(
 );
 void change_face(HalfFace *face, HalfEdge *halfedge);
 void change_vertex(HalfVertex *vertex, HalfEdge *halfedge);
-int check_split(HalfEdge *halfedge);
+int check_split(HalfEdge *halfedge, int slot = -1);
 
 /**
  * COllAPSE
  */
 int collapse_edges();
+int collapse_edges_by_priority();
+int collapse_edges_in_parallel();
+void queue_collapse(HalfEdge *halfedge);
 std::vector<HalfEdge*> collapse(HalfEdge *halfedge);
+int rewire_collapse(
+    HalfEdge *halfedge,
+    std::vector<HalfEdge*>& p_edges,
+    std::vector<HalfEdge*>& edges_to_remove
+);
 void add_removed_edges(
     std::set<HalfEdge*>& removed_edges,
     std::vector<HalfEdge*>& edges_to_remove
@@ -68,36 +224,92 @@ void add_removed_edges(
 void point_edges_to_q(std::vector<HalfEdge*>& p_onering, HalfVertex *q, HalfVertex *p);
 std::vector<HalfEdge*> connect_triangles(HalfEdge *halfedge);
 void remove_p(HalfEdge *halfedge, std::vector<HalfEdge*>& edges_to_remove);
+void bury_p(HalfEdge *halfedge, std::vector<HalfEdge*>& edges_to_remove);
+void forget_p(HalfEdge *halfedge);
 int check_if_edge_is_removed(HalfEdge *halfedge, std::set<HalfEdge*>& removed_edges);
-int check_collapse(HalfEdge *halfedge);
+int check_collapse(HalfEdge *halfedge, int slot = -1);
+int check_link_condition(HalfEdge *halfedge);
 int check_negative_area_ignore_faces(
-    std::vector<HalfFace*>& face_onering,
+    int vertex,
     HalfFace *f0,
     HalfFace *f1
 );
+int check_normal_flip_ignore_faces(
+    int vertex,
+    const vec3d& old_point,
+    HalfFace *f0,
+    HalfFace *f1
+);
+int check_normal_flip(
+    const double *old_point,
+    const double *new_point,
+    const double *u,
+    const double *w
+);
 /**
  * EQUALIZE VALENCES
  */
+int flip_edges();
+int flip_edges_in_parallel();
+int check_flip(HalfEdge *halfedge);
+void flip(HalfEdge *halfedge);
+void rewire_flip(HalfEdge *halfedge);
+int target_valence(int vertex);
+int improves_valences(int dq, int dp, int dr, int ds);
+int check_flip_normals(const double *q, const double *p, const double *r, const double *s);
 
 /**
  * TANGENTIAL RELAXATION
  */
 void relax_vertices();
-vec3d relax_vertex(HalfVertex *vertex);
-vec3d calculate_q(HalfVertex *p);
-vec3d calculate_n(HalfVertex *p);
-vec3d calculate_face_normal(HalfFace *face);
-void change_coordinates(std::map<HalfVertex*, vec3d>& new_points);
 
 /**
  * PROJECT TO SURFACE
  */
+void project_to_surface();
 
 
+/**
+ * COMPACT CORE
+ */
+std::pair<int,int> split_compact_edges();
+int collapse_compact_edges();
+int flip_compact_edges();
+void project_compact_to_surface();
+void collect_compact_edges(std::vector<CompactMesh::index_t>& halfedges);
+void measure_compact_ratios(std::vector<double>& ratios);
+void measure_compact_targets(const std::vector<CompactMesh::index_t>& halfedges);
+int check_compact_split(CompactMesh::index_t halfedge, int slot);
+int check_compact_collapse(CompactMesh::index_t halfedge, int slot);
+int check_compact_collapse_faces(CompactMesh::index_t halfedge);
+int check_compact_link_condition(CompactMesh::index_t halfedge);
+int check_compact_flip(CompactMesh::index_t halfedge);
+vec3d calculate_compact_middle(CompactMesh::index_t halfedge);
+
+/**
+ * PARALLEL SCHEDULING
+ */
+enum Region { COLLAPSE_REGION, SPLIT_REGION, FLIP_REGION };
+void select_independent_set(
+    std::vector<HalfEdge*>& candidates,
+    int round,
+    Region region,
+    std::vector<char>& selected
+);
+void get_region(HalfEdge *halfedge, Region region, std::vector<int>& vertices);
+unsigned long long round_key(int round, int candidate);
+
 /**
  * HELPER FUNCTIONS
  */
 void update_halfedge_vector();
+HalfVertex* create_vertex(const double *point);
+HalfEdge* create_edge();
+HalfFace* create_face();
+template<typename Element> void discard(Element *element);
+void touch_vertex(HalfVertex *vertex);
+void touch_onering(HalfVertex *vertex);
+void get_outgoing_edges(HalfVertex *vertex, std::vector<HalfEdge*>& edges);
 int is_boundary_edge(HalfEdge* halfedge);
 int has_boundary_vertex(HalfEdge *halfedge);
 
@@ -105,9 +317,27 @@ int has_boundary_vertex(HalfEdge *halfedge);
  * COMPUTATION
  */
 double get_length(HalfEdge *halfedge);
+double get_length(const double *a, const double *b);
+double get_ratio(HalfEdge *halfedge);
+double get_target(const vec3d& midpoint, int slot = -1);
+void measure_targets(const std::vector<HalfEdge*>& edges);
+void evaluate_targets(int num_edges);
 vec3d calculate_middle(HalfEdge *halfedge);
 };
 
+typedef BasicRemesher3d<SizingField<3>> Remesher3d;
+
+} // flux
+
+#include "remesher3d.tpp"
+
+namespace flux {
+
+// Compiled once in remesher3d.cpp instead of in every file that uses them
+extern template class BasicRemesher3d<SizingField<3>>;
+extern template class BasicRemesher3d<EdgelengthSizingField>;
+extern template class BasicRemesher3d<GridSizingField>;
+
 } // flux
 
 #endif
\ No newline at end of file
@@ -0,0 +1,3022 @@
+/**
+ * Member definitions of BasicRemesher3d, included at the end of
+ * remesher3d.h so any Field type can be instantiated. Only meant to be
+ * included from there
+ */
+#include "vec.hpp"
+#include "webgl.h"
+#include "mesh.h"
+#include "predicates.h"
+#include "parallel.h"
+#include "builder.h"
+#include "exact.h"
+#include "./sizing-fields/edgelengthsizingfield.h"
+#include "./sizing-fields/gridsizingfield.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <unordered_set>
+
+namespace flux {
+/**
+ * CONSTRUCTOR AND INITIALIZERS
+ */
+
+template<typename Field>
+BasicRemesher3d<Field>::BasicRemesher3d(
+    HalfEdgeMesh<Triangle>& halfmesh,
+    Field& sizing_field
+) :
+_halfmesh(halfmesh),
+_sizing_field(sizing_field),
+_batch_sizing_field(dynamic_cast<const BatchSizingField*>(&sizing_field)),
+_constant_size(_batch_sizing_field && _batch_sizing_field->is_constant()),
+_constant_target(0.0),
+_num_threads(1),
+_verbose(true),
+_priority_scheduling(false),
+_parallel_collapse(false),
+_parallel_split(false),
+_parallel_flip(false),
+_element_pool(false),
+_deferred_deletion(false),
+_active_set(false),
+_convergence_tolerance(-1.0),
+_ratio_report(true),
+_projection(false),
+_normal_flip_check(false),
+_gauss_seidel(false),
+_relaxation_factor(1.0),
+_reorder_churn(0.0),
+_churn(0),
+_compact_core(false),
+_checkpoint_interval(0),
+_num_snapshots(0),
+_pool(halfmesh),
+_split_queue(true),
+_collapse_queue(false)
+{
+    // A constant field is asked once, every later query reuses the answer
+    if (_constant_size) {
+        double origin[3] = {0.0, 0.0, 0.0};
+        _constant_target = _sizing_field(origin);
+    }
+}
+
+/**
+ * SETTINGS
+ */
+template<typename Field>
+void
+BasicRemesher3d<Field>::set_num_threads(int num_threads) {
+    /**
+     * Sets number of threads used by the parallel stages. Values < 1 select
+     * every hardware thread. Anything but 1 requires a sizing field that can
+     * be called concurrently
+     */
+    _num_threads = (num_threads < 1) ? hardware_threads() : num_threads;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::set_priority_scheduling(bool enabled) {
+    /**
+     * Chooses between one linear sweep over all edges per pass (default) and
+     * priority queues that split the longest / collapse the shortest edges
+     * first, including edges created during the same pass
+     */
+    _priority_scheduling = enabled;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::set_parallel_split(bool enabled) {
+    /**
+     * Splits non-adjacent edges concurrently in rounds (takes precedence over
+     * priority scheduling for the split pass)
+     */
+    _parallel_split = enabled;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::set_parallel_collapse(bool enabled) {
+    /**
+     * Collapses non-overlapping edges concurrently in rounds (takes precedence
+     * over priority scheduling for the collapse pass)
+     */
+    _parallel_collapse = enabled;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::set_parallel_flip(bool enabled) {
+    /**
+     * Flips edges whose quads share no vertex concurrently in rounds
+     */
+    _parallel_flip = enabled;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::set_element_pool(bool enabled) {
+    /**
+     * Recycles the elements freed by collapses for later splits instead of
+     * deleting and reallocating them one at a time. A free list only (see
+     * ElementPool): dead elements stay in the mesh until the end, and
+     * reordering no longer relocates elements
+     */
+    _element_pool = enabled;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::set_deferred_deletion(bool enabled) {
+    /**
+     * Only marks elements removed by collapses as dead, and erases all of them
+     * in one compaction pass at the end of each incremental_relaxation pass
+     */
+    _deferred_deletion = enabled;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::set_active_set(bool enabled) {
+    /**
+     * After the first incremental_relaxation pass, only visits edges around
+     * the vertices changed by the previous pass (and their one-rings)
+     */
+    _active_set = enabled;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::set_convergence_tolerance(double tolerance) {
+    /**
+     * Lets incremental_relaxation stop before num_iterations once a pass made
+     * no split or collapse and the 10th and 90th percentiles of the
+     * length/target ratio lie within [1 - tolerance, 1 + tolerance]. Values
+     * < 0 always run every pass
+     */
+    _convergence_tolerance = tolerance;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::set_ratio_report(bool enabled) {
+    /**
+     * Lets every IterationReport carry the length/target ratio percentiles
+     * (on by default). Off saves one target evaluation and selection over
+     * every edge per pass, unless a convergence tolerance needs them anyway
+     */
+    _ratio_report = enabled;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::set_projection(bool enabled) {
+    /**
+     * Moves every vertex onto the closest point of the mesh as it was when
+     * projection was first enabled (normally right after construction) after
+     * each relaxation step. Without projection no copy of the mesh is kept
+     */
+    _projection = enabled;
+    if (enabled && !_reference.nb_triangles()) _reference.snapshot(_halfmesh);
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::set_normal_flip_check(bool enabled) {
+    /**
+     * Rejects collapses that turn the normal of a surviving face around q by
+     * 90 degrees or more, instead of testing faces against the origin. Works
+     * wherever the mesh is placed
+     */
+    _normal_flip_check = enabled;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::set_gauss_seidel(bool enabled) {
+    /**
+     * Relaxes vertices in place, one colour class of the one-ring graph after
+     * the other, instead of all at once from the old positions (Jacobi)
+     */
+    _gauss_seidel = enabled;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::set_relaxation_factor(double factor) {
+    /**
+     * Moves every relaxed vertex factor of the way to its new position. Values
+     * below 1 damp the relaxation, values above 1 over-relax it
+     */
+    _relaxation_factor = factor;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::set_reorder_churn(double churn) {
+    /**
+     * Sorts the mesh elements along a space-filling curve at the end of any
+     * incremental_relaxation pass after which the vertices created or removed
+     * since the last sort exceed churn times the number of vertices. Values
+     * <= 0 never sort
+     */
+    _reorder_churn = churn;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::set_compact_core(bool enabled) {
+    /**
+     * Runs incremental_relaxation and tangential_relaxation on a CompactMesh
+     * (32-bit vertex and twin ids per halfedge) instead of the HalfEdgeMesh,
+     * which is converted once on entry and recreated on exit. Splits,
+     * collapses and flips are then done in linear sweeps; the parallel,
+     * priority, pool, active set, Gauss-Seidel and reordering settings do not
+     * apply
+     */
+    _compact_core = enabled;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::set_checkpoint(const std::string& filename, int interval) {
+    /**
+     * Saves the run to filename after every interval-th incremental_relaxation
+     * pass, from a background thread. Values < 1 never save
+     */
+    _checkpoint_file = filename;
+    _checkpoint_interval = interval;
+}
+
+template<typename Field>
+bool
+BasicRemesher3d<Field>::resume(const std::string& filename) {
+    /**
+     * Replaces the mesh and reference surface with the ones saved in
+     * filename. The next incremental_relaxation call carries on after the
+     * saved passes (num_iterations still counts them) and includes their
+     * reports and totals
+     *
+     * RETURNS: false if the checkpoint could not be read or holds no valid
+     * mesh (nothing changed)
+     */
+    Checkpoint checkpoint;
+    if (!load_checkpoint(filename, checkpoint)) return false;
+
+    // Built aside, so a checkpoint that is not a valid mesh leaves _halfmesh alone
+    Mesh<Triangle> no_triangles(3);
+    HalfEdgeMesh<Triangle> halfmesh(no_triangles);
+    if (!build_halfmesh(checkpoint.points.data(), checkpoint.points.size() / 3,
+        checkpoint.triangles.data(), checkpoint.triangles.size() / 3, halfmesh, _num_threads)) {
+        return false;
+    }
+    _halfmesh.vertices().swap(halfmesh.vertices());
+    _halfmesh.edges().swap(halfmesh.edges());
+    _halfmesh.faces().swap(halfmesh.faces());
+
+    // Runs saved without projection kept no reference surface
+    if (!checkpoint.reference.empty()) _reference.snapshot(checkpoint.reference);
+    _resumed_reports.swap(checkpoint.reports);
+    _churn = 0;
+    return true;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::set_snapshots(const std::string& prefix, const std::string& extension) {
+    /**
+     * Writes the mesh after every incremental_relaxation and
+     * tangential_relaxation pass to prefix0000extension, prefix0001extension,
+     * ... from a background thread (".obj" for OBJ, else a binary mesh
+     * file). An empty prefix writes nothing
+     */
+    _snapshot_prefix = prefix;
+    _snapshot_extension = extension;
+    _num_snapshots = 0;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::set_verbose(bool enabled) {
+    /**
+     * Lets incremental_relaxation print its pass and operation totals. Off
+     * when many remeshers share one output
+     */
+    _verbose = enabled;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::swap_scratch(RemesherScratch& scratch) {
+    /**
+     * Exchanges the scratch buffers with scratch. Called before a run to
+     * take over buffers grown by an earlier remesher and after it to hand
+     * them (grown further) back. Contents are rebuilt on every use, only
+     * capacity carries over
+     */
+    std::swap(_midpoints, scratch.midpoints);
+    std::swap(_targets, scratch.targets);
+    std::swap(_halfedge_vector, scratch.halfedge_vector);
+    std::swap(_edge_onering, scratch.edge_onering);
+    std::swap(_touched_vertices, scratch.touched_vertices);
+    std::swap(_onering_scratch, scratch.onering_scratch);
+    std::swap(_geometry, scratch.geometry);
+    std::swap(_compact, scratch.compact);
+    std::swap(_compact_ring, scratch.compact_ring);
+    std::swap(_compact_other_ring, scratch.compact_other_ring);
+}
+
+/**
+ * UTILITY FUNCTIONS
+ */
+template<typename Field>
+void
+BasicRemesher3d<Field>::print_stats() {
+    /**
+     * Prints statistics of the current halfmesh in Remesher3d objects
+     */
+    int num_vertices = 0, num_halfedges = 0, num_faces = 0, num_boundary_edges = 0;
+    int num_dead = 0;
+    double min_ratio = std::numeric_limits<double>::max(), max_ratio = 0.0;
+    double sum_ratio = 0.0;
+
+    for (auto& v : _halfmesh.vertices()) {
+        if (is_dead(v.get())) {
+            num_dead++;
+            continue;
+        }
+        num_vertices++;
+    }
+    for (auto& f : _halfmesh.faces()) {
+        if (is_dead(f.get())) {
+            num_dead++;
+            continue;
+        }
+        num_faces++;
+    }
+    for (auto& e : _halfmesh.edges()) {
+        HalfEdge *halfedge = e.get();
+        if (is_dead(halfedge)) {
+            num_dead++;
+            continue;
+        }
+        num_halfedges++;
+
+        // Every edge is measured once, from its face side
+        if (!halfedge->face) continue;
+        if (halfedge->twin->face && std::less<HalfEdge*>()(halfedge->twin, halfedge)) continue;
+        if (!halfedge->twin->face) num_boundary_edges++;
+
+        double ratio = get_ratio(halfedge);
+        min_ratio = std::min(min_ratio, ratio);
+        max_ratio = std::max(max_ratio, ratio);
+        sum_ratio += ratio;
+    }
+
+    int num_edges = num_halfedges / 2;
+    std::cout << "Vertices: \t" << num_vertices << "\nEdges: \t\t" << num_edges
+        << "\nFaces: \t\t" << num_faces << "\nBoundary Edges: " << num_boundary_edges
+        << "\nDead Elements: \t" << num_dead << std::endl;
+
+    if (!num_edges) return;
+    std::cout << "Length / Target: min " << min_ratio << ", mean " 
+        << sum_ratio / num_edges << ", max " << max_ratio << std::endl;
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::choose_algorithm() {
+    /**
+     * Prompts user to choose which remeshing algorithm to perform
+     * 
+     * RETURNS: -1 if invalid answer
+     */
+    std::cout << "Choose a remeshing algorithm to perform on sphere:" << '\n';
+    std::cout << "0. Tangential Relaxation" << '\n';
+
+    int user_response;
+
+    std::cin >> user_response;
+
+    if (user_response > 0 || user_response < 0) return -1;
+    return user_response;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::run_viewer() {
+    /**
+     * Runs viewer in flux360
+     */
+    Mesh<Triangle> mesh(3);
+    _halfmesh.extract(mesh);
+
+    Viewer viewer;
+    viewer.add(mesh);
+    viewer.run();
+}
+
+template<typename Field>
+HalfEdgeMesh<Triangle>&
+BasicRemesher3d<Field>::get_mesh() {
+    return _halfmesh;
+}
+
+/**
+ * EQUALIZE VALENCES
+ */
+template<typename Field>
+int
+BasicRemesher3d<Field>::flip_edges() {
+    /**
+     * Flips every interior edge whose flip brings the valences of its four
+     * vertices closer to their targets (6 inside, 4 on the boundary)
+     */
+    if (_compact_core) return flip_compact_edges();
+    flux_assert(_adjacency.is_built());
+    if (_parallel_flip) return flip_edges_in_parallel();
+
+    int num_flips = 0;
+    _touched_vertices.clear();
+    update_halfedge_vector();
+
+    // One halfedge per edge, flipping turns both
+    for (auto& halfedge : _halfedge_vector) {
+        if (_adjacency.index(halfedge->vertex) > _adjacency.index(halfedge->twin->vertex)) continue;
+        if (!check_flip(halfedge)) continue;
+
+        flip(halfedge);
+        num_flips++;
+    }
+
+    _touched_vertices.clear();
+    return num_flips;
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::flip_edges_in_parallel() {
+    /**
+     * Performs flips in rounds. Each round keeps the candidates that pass
+     * check_flip, picks edges whose quads share no vertex and flips them
+     * concurrently. Losers compete again in the next round, against the
+     * valences left by the winners
+     */
+    int num_flips = 0;
+    std::vector<HalfEdge*> candidates;
+    std::vector<char> status, selected;
+
+    _touched_vertices.clear();
+    update_halfedge_vector();
+
+    for (auto& e : _halfedge_vector) {
+        if (_adjacency.index(e->vertex) < _adjacency.index(e->twin->vertex)) {
+            candidates.push_back(e);
+        }
+    }
+
+    for (int round = 0; !candidates.empty(); ++round) {
+        int num_candidates = candidates.size();
+        status.assign(num_candidates, 0);
+
+        // Keeping the candidates that improve the valences now
+        parallel_for(num_candidates, _num_threads, [&](int, int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                status[i] = check_flip(candidates[i]);
+            }
+        });
+
+        int num_valid = 0;
+        for (int i = 0; i < num_candidates; ++i) {
+            if (status[i]) candidates[num_valid++] = candidates[i];
+        }
+        candidates.resize(num_valid);
+        if (!num_valid) break;
+
+        // Picking flips with disjoint quads and rewiring them concurrently
+        select_independent_set(candidates, round, FLIP_REGION, selected);
+        parallel_for(num_valid, _num_threads, [&](int, int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                if (selected[i]) rewire_flip(candidates[i]);
+            }
+        });
+
+        // Patching one-rings serially and keeping the losers for the next round
+        int num_losers = 0;
+        for (int i = 0; i < num_valid; ++i) {
+            HalfEdge *halfedge = candidates[i];
+            if (!selected[i]) {
+                candidates[num_losers++] = halfedge;
+                continue;
+            }
+
+            // halfedge now runs s -> r, q and p are the far corners
+            touch_vertex(halfedge->vertex);
+            touch_vertex(halfedge->twin->vertex);
+            touch_vertex(halfedge->next->next->vertex);
+            touch_vertex(halfedge->twin->next->next->vertex);
+            num_flips++;
+        }
+        candidates.resize(num_losers);
+        _touched_vertices.clear();
+    }
+
+    return num_flips;
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::check_flip(HalfEdge *halfedge) {
+    /**
+     * Checks if flipping halfedge (q -> p, with r opposite in its face and s
+     * opposite in its twin's face) lowers the squared deviation of the four
+     * valences from their targets, and if the two new triangles keep facing
+     * the same way as both old ones
+     */
+    if (is_boundary_edge(halfedge)) return 0;
+
+    HalfVertex *q = halfedge->vertex;
+    HalfVertex *p = halfedge->twin->vertex;
+    HalfVertex *r = halfedge->next->next->vertex;
+    HalfVertex *s = halfedge->twin->next->next->vertex;
+    if (r == s) return 0;
+
+    int qi = _adjacency.index(q), pi = _adjacency.index(p);
+    int ri = _adjacency.index(r), si = _adjacency.index(s);
+
+    // r and s must not be connected already, and q and p keep at least 3 edges
+    const int *r_onering = _adjacency.neighbours(ri);
+    for (int i = 0; i < _adjacency.valence(ri); ++i) {
+        if (r_onering[i] == si) return 0;
+    }
+    if (_adjacency.valence(qi) <= 3 || _adjacency.valence(pi) <= 3) return 0;
+
+    int dq = _adjacency.valence(qi) - target_valence(qi);
+    int dp = _adjacency.valence(pi) - target_valence(pi);
+    int dr = _adjacency.valence(ri) - target_valence(ri);
+    int ds = _adjacency.valence(si) - target_valence(si);
+
+    if (!improves_valences(dq, dp, dr, ds)) return 0;
+
+    return check_flip_normals(q->point.data(), p->point.data(), r->point.data(),
+        s->point.data());
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::improves_valences(int dq, int dp, int dr, int ds) {
+    /**
+     * Checks if a flip lowers the squared deviation of the valences from their
+     * targets, given the deviations before (q, p lose an edge, r, s gain one)
+     */
+    int before = dq * dq + dp * dp + dr * dr + ds * ds;
+    int after = (dq - 1) * (dq - 1) + (dp - 1) * (dp - 1) + (dr + 1) * (dr + 1)
+        + (ds + 1) * (ds + 1);
+    return after < before;
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::check_flip_normals(
+    const double *q,
+    const double *p,
+    const double *r,
+    const double *s
+) {
+    /**
+     * Checks if both triangles after flipping q -> p face the same way as both
+     * triangles before it
+     */
+    // Old triangles (q, p, r), (p, q, s) and new ones (r, q, s), (s, p, r)
+    vec3d qp, pp, rp, sp;
+    for (int d = 0; d < 3; ++d) {
+        qp[d] = q[d];
+        pp[d] = p[d];
+        rp[d] = r[d];
+        sp[d] = s[d];
+    }
+    vec3d n0, n1, m0, m1;
+    vec3d e[8] = {pp - qp, rp - qp, qp - pp, sp - pp, qp - rp, sp - rp, pp - sp, rp - sp};
+    for (int i = 0; i < 3; ++i) {
+        int j = (i + 1) % 3, k = (i + 2) % 3;
+        n0[i] = e[0][j] * e[1][k] - e[0][k] * e[1][j];
+        n1[i] = e[2][j] * e[3][k] - e[2][k] * e[3][j];
+        m0[i] = e[4][j] * e[5][k] - e[4][k] * e[5][j];
+        m1[i] = e[6][j] * e[7][k] - e[6][k] * e[7][j];
+    }
+
+    if (dot(m0, n0) <= 0 || dot(m0, n1) <= 0) return 0;
+    if (dot(m1, n0) <= 0 || dot(m1, n1) <= 0) return 0;
+    return 1;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::flip(HalfEdge *halfedge) {
+    /**
+     * Flips halfedge and patches the one-rings of its four vertices
+     */
+    HalfVertex *q = halfedge->vertex;
+    HalfVertex *p = halfedge->twin->vertex;
+
+    rewire_flip(halfedge);
+
+    touch_vertex(q);
+    touch_vertex(p);
+    touch_vertex(halfedge->vertex);
+    touch_vertex(halfedge->twin->vertex);
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::rewire_flip(HalfEdge *halfedge) {
+    /**
+     * Turns interior halfedge q -> p into s -> r (and its twin into r -> s),
+     * replacing triangles (q, p, r), (p, q, s) with (s, r, q), (r, s, p). Only
+     * elements of the two triangles and q, p are changed
+     */
+    HalfEdge *twin = halfedge->twin;
+    HalfEdge *h1 = halfedge->next;  // p -> r
+    HalfEdge *h2 = h1->next;        // r -> q
+    HalfEdge *t1 = twin->next;      // q -> s
+    HalfEdge *t2 = t1->next;        // s -> p
+
+    HalfVertex *q = halfedge->vertex;
+    HalfVertex *p = twin->vertex;
+    HalfVertex *r = h2->vertex;
+    HalfVertex *s = t2->vertex;
+
+    HalfFace *f0 = halfedge->face;
+    HalfFace *f1 = twin->face;
+
+    // (s, r, q) in f0 and (r, s, p) in f1
+    change_edge(halfedge, h2, nullptr, s, nullptr);
+    change_edge(h2, t1, nullptr, nullptr, f0);
+    change_edge(t1, halfedge, nullptr, nullptr, f0);
+
+    change_edge(twin, t2, nullptr, r, nullptr);
+    change_edge(t2, h1, nullptr, nullptr, f1);
+    change_edge(h1, twin, nullptr, nullptr, f1);
+
+    change_face(f0, halfedge);
+    change_face(f1, twin);
+
+    // q and p no longer start halfedge and twin
+    if (q->edge == halfedge) change_vertex(q, t1);
+    if (p->edge == twin) change_vertex(p, h1);
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::target_valence(int vertex) {
+    /**
+     * Ideal valence of vertex: 6 inside the mesh, 4 on its boundary
+     */
+    return (_adjacency.vertex(vertex)->index <= -1) ? 4 : 6;
+}
+
+/**
+ * TANGENTIAL RELAXATION
+ */
+template<typename Field>
+void
+BasicRemesher3d<Field>::tangential_relaxation(int num_iterations) {
+    /**
+     * Performs tangential relaxation on the mesh
+     */  
+    // Relaxation does not change connectivity, so one build serves every pass
+    if (_compact_core) {
+        _compact.import_mesh(_halfmesh);
+    } else {
+        _adjacency.build(_halfmesh, _num_threads);
+        _color_offsets.clear();
+    }
+
+    for (int i = 0; i < num_iterations; ++i) {
+        relax_vertices();
+        if (_projection) project_to_surface();
+        snapshot();
+    }
+    finish_snapshots();
+
+    if (_compact_core) {
+        _compact.export_mesh(_halfmesh);
+        _compact.clear();
+    }
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::relax_vertices() {
+    /**
+     * Relaxes every vertex in _adjacency at once (Jacobi update). Coordinates
+     * are gathered into _geometry, face normals, one-ring normals, centroids
+     * and new points are computed in batches from the old positions, and only
+     * then written back into the halfmesh. With Gauss-Seidel, each colour
+     * class is relaxed in parallel from the positions left by the previous
+     * classes. The compact core always uses the Jacobi update
+     */
+    if (_compact_core) {
+        _compact.relax(_relaxation_factor, _num_threads);
+        return;
+    }
+    flux_assert(_adjacency.is_built());
+
+    _geometry.gather(_adjacency, _num_threads);
+
+    if (_gauss_seidel) {
+        // Colours are kept until the connectivity changes
+        if (_color_offsets.empty()) _adjacency.color(_color_offsets, _colored_vertices);
+
+        for (int c = 0; c + 1 < (int) _color_offsets.size(); ++c) {
+            _geometry.relax_in_place(
+                _adjacency,
+                &_colored_vertices[_color_offsets[c]],
+                _color_offsets[c + 1] - _color_offsets[c],
+                _relaxation_factor,
+                _num_threads
+            );
+        }
+        _geometry.scatter_points(_adjacency, _num_threads);
+        return;
+    }
+
+    _geometry.compute_face_normals(_adjacency, _num_threads);
+    _geometry.compute_vertex_normals(_adjacency, _num_threads);
+    _geometry.compute_centroids(_adjacency, _num_threads);
+    _geometry.compute_relaxed_points(_relaxation_factor, _num_threads);
+    _geometry.scatter(_adjacency, _num_threads);
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::correct_tangential_relaxation(SphereTetFunction& function) {
+    /**
+     * Realigns vertices to place on the sphere itself
+     */
+    HalfVertex *vertex;
+    vec3d original_point;
+    vec3d new_point;
+    vec3d distance_to_new_point;
+    for (auto& v : _halfmesh.vertices()) {
+        vertex = v.get();
+        if (is_dead(vertex)) continue;
+        original_point = vertex->point;
+        distance_to_new_point = function(original_point);
+        
+        for (int i = 0; i < 3; ++i) {
+            distance_to_new_point[i] = -1 * distance_to_new_point[i];
+        }
+
+        new_point = distance_to_new_point + original_point;
+
+        vertex->point = new_point;
+    }
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::project_to_implicit(
+    const ImplicitFunction& function,
+    double tolerance,
+    int max_iterations
+) {
+    /**
+     * Moves every vertex onto the zero level set of function with Newton
+     * steps x' = x - f(x) * grad f(x) / |grad f(x)|^2. A vertex stops once
+     * |f(x)| / |grad f(x)| (its estimated distance to the surface) is below
+     * tolerance. Each thread takes a range of the vertices and evaluates
+     * function and its gradient in batches of PROJECTION_BATCH points
+     *
+     * RETURNS: number of vertices that were not within tolerance after
+     * max_iterations steps, or stalled on a zero gradient before
+     */
+    const int PROJECTION_BATCH = 64;
+
+    std::vector<HalfVertex*> vertices;
+    for (auto& v : _halfmesh.vertices()) {
+        if (!is_dead(v.get())) vertices.push_back(v.get());
+    }
+
+    int num_vertices = vertices.size();
+    std::vector<int> num_unconverged(std::max(1, std::min(_num_threads, num_vertices)), 0);
+
+    parallel_for(num_vertices, _num_threads, [&](int thread, int begin, int end) {
+        double points[3 * PROJECTION_BATCH];
+        double values[PROJECTION_BATCH];
+        double gradients[3 * PROJECTION_BATCH];
+        int owners[PROJECTION_BATCH];
+
+        for (int first = begin; first < end; first += PROJECTION_BATCH) {
+            int num_points = std::min(PROJECTION_BATCH, end - first);
+            for (int i = 0; i < num_points; ++i) {
+                owners[i] = first + i;
+                for (int d = 0; d < 3; ++d) points[3 * i + d] = vertices[first + i]->point[d];
+            }
+
+            for (int iteration = 0; iteration < max_iterations && num_points; ++iteration) {
+                function.evaluate(points, num_points, values);
+                function.gradient(points, num_points, gradients);
+
+                // Stepping the points that are still too far, packed to the front
+                int num_left = 0;
+                for (int i = 0; i < num_points; ++i) {
+                    double *g = &gradients[3 * i];
+                    double g2 = g[0] * g[0] + g[1] * g[1] + g[2] * g[2];
+                    bool converged = fabs(values[i]) <= tolerance * sqrt(g2);
+
+                    // Without a gradient there is no step, the point has stalled
+                    bool stalled = !converged && g2 == 0.0;
+                    if (stalled) num_unconverged[thread]++;
+                    bool done = converged || stalled;
+
+                    double step = done ? 0.0 : values[i] / g2;
+                    for (int d = 0; d < 3; ++d) {
+                        double coordinate = points[3 * i + d] - step * g[d];
+                        vertices[owners[i]]->point[d] = coordinate;
+                        points[3 * num_left + d] = coordinate;
+                    }
+                    if (done) continue;
+                    owners[num_left] = owners[i];
+                    num_left++;
+                }
+                num_points = num_left;
+            }
+
+            // Points left over took their last step without being checked
+            if (num_points) {
+                function.evaluate(points, num_points, values);
+                function.gradient(points, num_points, gradients);
+                for (int i = 0; i < num_points; ++i) {
+                    double *g = &gradients[3 * i];
+                    double g2 = g[0] * g[0] + g[1] * g[1] + g[2] * g[2];
+                    if (fabs(values[i]) > tolerance * sqrt(g2)) num_unconverged[thread]++;
+                }
+            }
+        }
+    });
+
+    int total = 0;
+    for (int count : num_unconverged) total += count;
+    return total;
+}
+
+
+template<typename Field>
+std::vector<IterationReport>
+BasicRemesher3d<Field>::incremental_relaxation(int num_iterations) {
+    /**
+     * Implementation of the incremental relaxation remeshing algorithm
+     *
+     * RETURNS: one report per pass that was run. Its ratio percentiles are
+     * measured after the pass unless set_ratio_report(false) turned them off
+     * (and no convergence tolerance is set), in which case they are 0
+     */
+    std::vector<IterationReport> reports;
+    int num_splits = 0, num_boundary_splits = 0, num_collapses = 0, num_flips = 0;
+
+    // Passes restored by resume() count as done
+    reports.swap(_resumed_reports);
+    for (auto& report : reports) {
+        num_splits += report.num_splits;
+        num_boundary_splits += report.num_boundary_splits;
+        num_collapses += report.num_collapses;
+        num_flips += report.num_flips;
+    }
+
+    // One-rings are built once and patched by every split/collapse
+    if (_compact_core) {
+        _compact.import_mesh(_halfmesh);
+    } else {
+        _adjacency.build(_halfmesh, _num_threads);
+        _color_offsets.clear();
+    }
+
+    // The first pass visits every edge
+    _active_vertices.clear();
+    _changed_vertices.clear();
+
+    for (int i = reports.size(); i < num_iterations; ++i) {
+        IterationReport report;
+
+        // Split long edges
+        std::pair<int,int> splits = split_edges();
+        report.num_splits = splits.first;
+        report.num_boundary_splits = splits.second;
+
+        // Collapse short edges
+        report.num_collapses = collapse_edges();
+
+        // Equalize valences
+        report.num_flips = flip_edges();
+
+        // Tangential relaxation
+        // relax_vertices();
+
+        // Project to surface
+        if (_projection) project_to_surface();
+
+        // Erase what the pass removed and renumber the survivors
+        compact();
+
+        measure_ratios(report);
+        reports.push_back(report);
+        snapshot();
+
+        num_splits += report.num_splits;
+        num_boundary_splits += report.num_boundary_splits;
+        num_collapses += report.num_collapses;
+        num_flips += report.num_flips;
+
+        if (has_converged(report)) break;
+        if (_checkpoint_interval > 0 && (i + 1) % _checkpoint_interval == 0) checkpoint(reports);
+    }
+
+    if (_checkpoint_interval > 0 && !_checkpoint_writer.wait()) {
+        std::cout << "Could not write checkpoint " << _checkpoint_file << std::endl;
+    }
+    finish_snapshots();
+
+    // Recycled elements that were never reused leave the mesh here
+    if (_element_pool) _pool.trim();
+    if (_compact_core) {
+        _compact.export_mesh(_halfmesh);
+        _compact.clear();
+    }
+
+    if (_verbose) {
+        std::cout << "Passes: \t" << reports.size() << "\nSplits: \t" << num_splits
+            << "\nBoundary Splits: " << num_boundary_splits << "\nCollapses: \t"
+            << num_collapses << "\nFlips: \t\t" << num_flips << std::endl;
+    }
+
+    return reports;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::checkpoint(const std::vector<IterationReport>& reports) {
+    /**
+     * Copies the reports, mesh and reference surface into _checkpoint and
+     * hands it to the background writer. Only the copy holds up the pass
+     */
+    _checkpoint.reports = reports;
+    if (_compact_core) {
+        _compact.extract(_checkpoint.points, _checkpoint.triangles);
+    } else {
+        extract_halfmesh(_halfmesh, _checkpoint.points, _checkpoint.triangles, _num_threads);
+    }
+    _checkpoint.reference = _reference.corners();
+
+    _checkpoint_writer.write(_checkpoint_file, _checkpoint);
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::snapshot() {
+    /**
+     * Copies the mesh into _snapshot and hands it to the background writer,
+     * which swaps in the buffer of its previous write. The pass only waits
+     * if that write is still running
+     */
+    if (_snapshot_prefix.empty()) return;
+
+    if (_compact_core) {
+        _compact.extract(_snapshot.points, _snapshot.triangles);
+    } else {
+        extract_halfmesh(_halfmesh, _snapshot.points, _snapshot.triangles, _num_threads);
+    }
+
+    std::ostringstream filename;
+    filename << _snapshot_prefix << std::setw(4) << std::setfill('0') << _num_snapshots++
+        << _snapshot_extension;
+    _snapshot_writer.write(filename.str(), _snapshot);
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::finish_snapshots() {
+    /**
+     * Waits for the last snapshot of a run and reports failed writes
+     */
+    if (_snapshot_prefix.empty()) return;
+    if (!_snapshot_writer.wait()) {
+        std::cout << "Could not write every snapshot " << _snapshot_prefix << "*"
+            << _snapshot_extension << std::endl;
+    }
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::activate(std::vector<HalfVertex*>& changed) {
+    /**
+     * Makes changed and their one-rings the active set of the next pass
+     */
+    _active_vertices.assign(_adjacency.nb_vertices(), 0);
+    _changed_vertices.assign(_adjacency.nb_vertices(), 0);
+
+    for (HalfVertex *vertex : changed) {
+        int v = _adjacency.index(vertex);
+        const int *onering = _adjacency.neighbours(v);
+
+        _active_vertices[v] = 1;
+        for (int i = 0; i < _adjacency.valence(v); ++i) {
+            _active_vertices[onering[i]] = 1;
+        }
+    }
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::compact() {
+    /**
+     * Erases every element left dead by deferred deletion in one pass per
+     * container, then rebuilds _adjacency so the surviving vertices and faces
+     * get contiguous ids again (and patched rows are packed). With _pool in
+     * use the dead elements are waiting to be reused and are kept until the
+     * end of the run. Also reorders the mesh after enough churn and seeds the
+     * next active set
+     */
+    if (_compact_core) {
+        _compact.compact();
+        return;
+    }
+
+    // Ids change with the rebuild, vertices changed by the pass are carried over
+    std::vector<HalfVertex*> changed;
+    if (_active_set) {
+        for (int v = 0; v < (int) _changed_vertices.size(); ++v) {
+            if (_changed_vertices[v] && _adjacency.vertex(v)) {
+                changed.push_back(_adjacency.vertex(v));
+            }
+        }
+    }
+
+    if (_deferred_deletion && !_element_pool) erase_dead(_halfmesh);
+    if (_reorder_churn > 0 && _churn > _reorder_churn * _adjacency.nb_vertices()) {
+        reorder(changed);
+    }
+    _adjacency.build(_halfmesh, _num_threads);
+    _color_offsets.clear();
+
+    if (_active_set) activate(changed);
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::reorder(std::vector<HalfVertex*>& tracked) {
+    /**
+     * Sorts the mesh elements along a Morton curve, recreating them in that
+     * order unless _pool holds on to dead ones. tracked is kept pointing at
+     * the same vertices. _adjacency has to be rebuilt afterwards
+     */
+    reorder_mesh(_halfmesh, !_element_pool, tracked);
+    _churn = 0;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::measure_ratios(IterationReport& report) {
+    /**
+     * Fills the ratio fields of report with the min, 10th percentile, median,
+     * 90th percentile and max of the length/target ratio over every live edge.
+     * Left at 0 when neither the report nor a convergence test needs them
+     */
+    report.min_ratio = report.p10_ratio = report.median_ratio = 0.0;
+    report.p90_ratio = report.max_ratio = 0.0;
+    if (!_ratio_report && _convergence_tolerance < 0) return;
+
+    std::vector<double> ratios;
+    if (_compact_core) {
+        measure_compact_ratios(ratios);
+    } else {
+        std::vector<HalfEdge*> edges;
+        for (auto& e : _halfmesh.edges()) {
+            HalfEdge *halfedge = e.get();
+            if (is_dead(halfedge)) continue;
+
+            // Every edge is measured once, from its face side
+            if (!halfedge->face) continue;
+            if (halfedge->twin->face && std::less<HalfEdge*>()(halfedge->twin, halfedge)) continue;
+            edges.push_back(halfedge);
+        }
+
+        ratios.resize(edges.size());
+        measure_targets(edges);
+        parallel_for(edges.size(), _num_threads, [&](int, int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                ratios[i] = get_length(edges[i]) / _targets[i];
+            }
+        });
+    }
+
+    if (ratios.empty()) return;
+
+    // Selection instead of a full sort, only five order statistics are needed
+    int num_edges = ratios.size();
+    auto percentile = [&](int k) {
+        std::nth_element(ratios.begin(), ratios.begin() + k, ratios.end());
+        return ratios[k];
+    };
+    auto extremes = std::minmax_element(ratios.begin(), ratios.end());
+    report.min_ratio = *extremes.first;
+    report.max_ratio = *extremes.second;
+    report.p10_ratio = percentile((num_edges - 1) / 10);
+    report.median_ratio = percentile((num_edges - 1) / 2);
+    report.p90_ratio = percentile(9 * (num_edges - 1) / 10);
+}
+
+template<typename Field>
+bool
+BasicRemesher3d<Field>::has_converged(const IterationReport& report) {
+    /**
+     * Checks whether the pass behind report made no split or collapse and
+     * left the 10th to 90th percentile of the ratios within
+     * _convergence_tolerance of 1 (edges as long as their targets)
+     */
+    if (_convergence_tolerance < 0) return false;
+    if (report.num_splits || report.num_boundary_splits || report.num_collapses) return false;
+
+    return report.p10_ratio >= 1.0 - _convergence_tolerance
+        && report.p90_ratio <= 1.0 + _convergence_tolerance;
+}
+
+/**
+ * SPLIT
+ */
+template<typename Field>
+std::pair<int,int>
+BasicRemesher3d<Field>::split_edges() {
+    /**
+     * Performs splits on appropriate edges
+     */
+    if (_compact_core) return split_compact_edges();
+    if (_parallel_split) return split_edges_in_parallel();
+    if (_priority_scheduling) return split_edges_by_priority();
+
+    int num_splits = 0, num_boundary_splits = 0;
+    update_halfedge_vector();
+    measure_targets(_halfedge_vector);
+
+    for (int i = 0; i < (int) _halfedge_vector.size(); ++i) {
+        HalfEdge *halfedge = _halfedge_vector[i];
+        switch (check_split(halfedge, i)) {
+            case 1:
+                split(halfedge);
+                num_splits++;
+                break;
+            case 2:
+                split_boundary(halfedge);
+                num_boundary_splits++;
+                break;
+            default:
+                break;
+        }
+    }
+
+    _touched_vertices.clear();
+    return std::make_pair(num_splits, num_boundary_splits);
+}
+
+template<typename Field>
+std::pair<int,int>
+BasicRemesher3d<Field>::split_edges_by_priority() {
+    /**
+     * Performs splits from the longest edge (relative to its target length)
+     * down. Halfedges around the vertices touched by a split are re-queued, so
+     * the new edges are considered in this pass too
+     */
+    int num_splits = 0, num_boundary_splits = 0;
+    HalfEdge *halfedge;
+    double ratio;
+
+    _split_queue.clear();
+    _touched_vertices.clear();
+    update_halfedge_vector();
+
+    // One halfedge per edge is enough, split() handles both sides
+    for (auto& e : _halfedge_vector) {
+        if (_adjacency.index(e->vertex) < _adjacency.index(e->twin->vertex)) {
+            queue_split(e);
+        }
+    }
+
+    while (_split_queue.pop(halfedge, ratio)) {
+        switch (check_split(halfedge)) {
+            case 1:
+                split(halfedge);
+                num_splits++;
+                break;
+            case 2:
+                split_boundary(halfedge);
+                num_boundary_splits++;
+                break;
+            default:
+                continue;
+        }
+
+        for (int v : _touched_vertices) _split_queue.touch(v);
+        for (int v : _touched_vertices) {
+            get_outgoing_edges(_adjacency.vertex(v), _edge_onering);
+            for (HalfEdge *e : _edge_onering) queue_split(e);
+        }
+        _touched_vertices.clear();
+    }
+
+    return std::make_pair(num_splits, num_boundary_splits);
+}
+
+template<typename Field>
+std::pair<int,int>
+BasicRemesher3d<Field>::split_edges_in_parallel() {
+    /**
+     * Performs splits in rounds. Each round keeps the candidates that pass
+     * check_split, picks among them edges whose triangles share no vertex
+     * (select_independent_set), creates every vertex, halfedge and face the
+     * round needs at once and lets the threads rewire them. Like the linear
+     * sweep, only edges that existed at the start of the pass are considered
+     */
+    int num_splits = 0, num_boundary_splits = 0;
+    std::vector<HalfEdge*> candidates;
+    std::vector<char> kind, selected;
+    std::vector<int> vertex_offset, edge_offset, face_offset, regions;
+    std::vector<vec3d> midpoints;
+    std::vector<HalfVertex*> new_vertices;
+    std::vector<HalfEdge*> new_edges;
+    std::vector<HalfFace*> new_faces;
+    std::vector<int> region;
+
+    _touched_vertices.clear();
+    update_halfedge_vector();
+
+    // One halfedge per edge is enough, split() handles both sides
+    for (auto& e : _halfedge_vector) {
+        if (_adjacency.index(e->vertex) < _adjacency.index(e->twin->vertex)) {
+            candidates.push_back(e);
+        }
+    }
+
+    for (int round = 0; !candidates.empty(); ++round) {
+        int num_candidates = candidates.size();
+        kind.assign(num_candidates, 0);
+
+        // Keeping the candidates that can be split now (1: interior, 2: boundary)
+        measure_targets(candidates);
+        parallel_for(num_candidates, _num_threads, [&](int, int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                kind[i] = check_split(candidates[i], i);
+            }
+        });
+
+        int num_valid = 0;
+        for (int i = 0; i < num_candidates; ++i) {
+            if (!kind[i]) continue;
+            candidates[num_valid] = candidates[i];
+            kind[num_valid++] = kind[i];
+        }
+        candidates.resize(num_valid);
+        kind.resize(num_valid);
+        if (!num_valid) break;
+
+        // Picking splits with disjoint triangles
+        select_independent_set(candidates, round, SPLIT_REGION, selected);
+
+        // Numbering the new elements of every selected split
+        int num_new_vertices = 0, num_new_edges = 0, num_new_faces = 0;
+        vertex_offset.assign(num_valid, -1);
+        edge_offset.assign(num_valid, -1);
+        face_offset.assign(num_valid, -1);
+        regions.assign(4 * num_valid, -1);
+        midpoints.resize(num_valid);
+
+        for (int i = 0; i < num_valid; ++i) {
+            if (!selected[i]) continue;
+            vertex_offset[i] = num_new_vertices++;
+            edge_offset[i] = num_new_edges;
+            face_offset[i] = num_new_faces;
+            num_new_edges += (kind[i] == 1) ? 6 : 4;
+            num_new_faces += (kind[i] == 1) ? 2 : 1;
+
+            // Remembered before rewiring to patch the one-rings afterwards
+            get_region(candidates[i], SPLIT_REGION, region);
+            std::copy(region.begin(), region.end(), &regions[4 * i]);
+            midpoints[i] = calculate_middle(candidates[i]);
+        }
+
+        // Creating them in bulk, one kind of element after the other
+        if (_element_pool) _pool.reserve(num_new_vertices, num_new_edges, num_new_faces);
+        new_vertices.resize(num_new_vertices);
+        new_edges.resize(num_new_edges);
+        new_faces.resize(num_new_faces);
+        for (int i = 0; i < num_valid; ++i) {
+            if (!selected[i]) continue;
+            new_vertices[vertex_offset[i]] = create_vertex(midpoints[i].data());
+        }
+        for (auto& e : new_edges) e = create_edge();
+        for (auto& f : new_faces) f = create_face();
+
+        // Rewiring concurrently, selected splits share no element
+        parallel_for(num_valid, _num_threads, [&](int, int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                if (!selected[i]) continue;
+
+                HalfVertex *new_vertex = new_vertices[vertex_offset[i]];
+                HalfEdge **edges = &new_edges[edge_offset[i]];
+                HalfFace **faces = &new_faces[face_offset[i]];
+
+                if (kind[i] == 1) {
+                    rewire_split(candidates[i], new_vertex, edges, faces);
+                } else {
+                    rewire_split_boundary(candidates[i], new_vertex, edges, faces[0]);
+                }
+            }
+        });
+
+        // Patching one-rings serially and keeping the losers for the next round
+        int num_losers = 0;
+        for (int i = 0; i < num_valid; ++i) {
+            if (!selected[i]) {
+                candidates[num_losers++] = candidates[i];
+                continue;
+            }
+
+            touch_vertex(new_vertices[vertex_offset[i]]);
+            for (int j = 0; j < 4; ++j) {
+                if (regions[4 * i + j] >= 0) touch_vertex(_adjacency.vertex(regions[4 * i + j]));
+            }
+
+            if (kind[i] == 1) {
+                num_splits++;
+            } else {
+                num_boundary_splits++;
+            }
+        }
+        candidates.resize(num_losers);
+    }
+
+    _touched_vertices.clear();
+    return std::make_pair(num_splits, num_boundary_splits);
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::queue_split(HalfEdge *halfedge) {
+    /**
+     * Adds halfedge to _split_queue if it is long enough to be split
+     */
+    double ratio = get_ratio(halfedge);
+    if (ratio < sqrt(2)) return;
+
+    _split_queue.push(
+        halfedge,
+        _adjacency.index(halfedge->vertex),
+        _adjacency.index(halfedge->twin->vertex),
+        ratio
+    );
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::check_split(HalfEdge* halfedge, int slot) {
+    /**
+     * Checks if halfedge is valid for a split operation. slot, if >= 0, is
+     * the position of halfedge in the last measure_targets() call
+     *
+     * RETURNS: 0 for no split, 1 for an interior split, 2 for a boundary split
+     */
+    double length = get_length(halfedge);
+
+    // Get midpoint of halfedge
+    vec3d midpoint_vec = calculate_middle(halfedge);
+
+    // Check if creates short edges
+    vec3d r_point = halfedge->next->next->vertex->point;
+    vec3d s_point = halfedge->twin->next->next->vertex->point;
+
+    double new_edge1 = norm(r_point - midpoint_vec);
+    double new_edge2 = norm(midpoint_vec - s_point); 
+
+    double analytical_length = get_target(midpoint_vec, slot);
+
+    // Edge check
+    double ratio = length / analytical_length;
+
+    if (ratio < sqrt(2)) return 0;     // no split
+
+    // Short edge creation check
+    double p_ratio = new_edge1 / analytical_length;
+    double s_ratio = new_edge2 / analytical_length;
+
+    if (p_ratio < 0.6 || s_ratio < 0.6) return 0; // no split >>> creates short edges
+    if (is_boundary_edge(halfedge)) return 2;     // boundary split
+    return 1;    
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::split(HalfEdge* halfedge) {
+    /**
+     * Splits (long) halfedge into 4 edges
+     */
+    HalfVertex *q = halfedge->vertex;
+    HalfVertex *p = halfedge->twin->vertex;
+    HalfVertex *r = halfedge->next->next->vertex;
+    HalfVertex *s = halfedge->twin->next->next->vertex;
+
+    // Calculating coordinates for new point
+    vec3d new_point_coords = calculate_middle(halfedge);
+
+    // Initialize new vertex, edges a,b,c,d,e,f and faces f2,f3
+    HalfVertex *new_vertex = create_vertex(new_point_coords.data());
+    HalfEdge *edges[6];
+    for (int i = 0; i < 6; ++i) {
+        edges[i] = create_edge();
+    }
+    HalfFace *faces[2];
+    faces[0] = create_face();
+    faces[1] = create_face();
+
+    rewire_split(halfedge, new_vertex, edges, faces);
+
+    // Patching one-rings of every vertex touching the four new triangles
+    touch_vertex(new_vertex);
+    touch_vertex(q);
+    touch_vertex(p);
+    touch_vertex(r);
+    touch_vertex(s);
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::rewire_split(
+    HalfEdge *halfedge,
+    HalfVertex *new_vertex,
+    HalfEdge *edges[6],
+    HalfFace *faces[2]
+) {
+    /**
+     * Connects already created elements so that new_vertex splits halfedge and
+     * both of its triangles in two. Only elements of the two triangles are
+     * changed
+     *
+     * PARAMS:
+     * halfedge:   pointer to the HalfEdge being split
+     * new_vertex: vertex placed at the middle of halfedge
+     * edges:      the six new halfedges a,b,c,d,e,f
+     * faces:      the two new faces f2,f3
+     */
+    // Defining current setup
+    HalfEdge *twin = halfedge->twin;
+    HalfEdge *tr = halfedge->next;
+    HalfEdge *tl = tr->next;
+    HalfEdge *bl = twin->next;
+    HalfEdge *br = bl->next;
+
+    HalfVertex *p = halfedge->twin->vertex;
+    HalfVertex *r = halfedge->next->next->vertex;
+    HalfVertex *s = twin->next->next->vertex;
+
+    HalfFace *f1 = halfedge->face;
+    HalfFace *f4 = twin->face;
+
+    // Setting up triangles
+    HalfEdge *a = edges[0];
+    HalfEdge *b = edges[1];
+    HalfEdge *c = edges[2];
+    HalfEdge *d = edges[3];
+    HalfEdge *e = edges[4];
+    HalfEdge *f = edges[5];
+
+    HalfFace *f2 = faces[0];
+    HalfFace *f3 = faces[1];
+
+    // Setting edges a,b,c,d,e,f
+    change_edge(a, tl, b, new_vertex, f1);
+    change_edge(b, c, a, r, f2);
+    change_edge(c, tr, d, new_vertex, f2);
+    change_edge(d, e, c, p, f3);
+    change_edge(e, br, f, new_vertex, f3);
+    change_edge(f, twin, e, s, f4);
+    
+    // Connecting previous mesh componenets to new ones (and the new vertex)
+    change_edge(halfedge, a, nullptr, nullptr, nullptr);
+    change_edge(twin, nullptr, nullptr, new_vertex, nullptr);
+
+    change_edge(tr, b, nullptr, nullptr, f2);
+    change_edge(br, d, nullptr, nullptr, f3);
+    change_edge(bl, f, nullptr, nullptr, f4);
+
+    change_vertex(new_vertex, a);
+    change_vertex(p, d);
+    
+    change_face(f1, halfedge);
+    change_face(f2, b);
+    change_face(f3, d);
+    change_face(f4, twin);
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::split_boundary(HalfEdge *halfedge) {
+    /**
+     * Peforms split operation on boundary edge
+     */
+    HalfEdge *inner = (halfedge->face != nullptr) ? halfedge : halfedge->twin;
+    HalfVertex *q = inner->vertex;
+    HalfVertex *p = inner->twin->vertex;
+    HalfVertex *r = inner->next->next->vertex;
+
+    vec3d new_point_coords = calculate_middle(halfedge);
+
+    // Initialize new vertex, edges a,b,c,d and face f2
+    HalfVertex *new_vertex = create_vertex(new_point_coords.data());
+    HalfEdge *edges[4];
+    for (int i = 0; i < 4; ++i) {
+        edges[i] = create_edge();
+    }
+    HalfFace *face = create_face();
+
+    rewire_split_boundary(halfedge, new_vertex, edges, face);
+
+    // Patching one-rings of every vertex touching the two new triangles
+    touch_vertex(new_vertex);
+    touch_vertex(q);
+    touch_vertex(p);
+    touch_vertex(r);
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::rewire_split_boundary(
+    HalfEdge *halfedge,
+    HalfVertex *new_vertex,
+    HalfEdge *edges[4],
+    HalfFace *face
+) {
+    /**
+     * Connects already created elements so that new_vertex splits boundary
+     * halfedge and its triangle in two. Only elements of the triangle and the
+     * boundary halfedges around halfedge are changed
+     *
+     * PARAMS:
+     * halfedge:   pointer to the (boundary) HalfEdge being split
+     * new_vertex: vertex placed at the middle of halfedge
+     * edges:      the four new halfedges a,b,c,d
+     * face:       the new face f2
+     */
+    HalfEdge *inner, *twin;
+
+    flux_assert((halfedge->face == nullptr )!= (halfedge->twin->face == nullptr));
+
+    if (halfedge->face != nullptr) {
+        inner = halfedge;
+    } else {
+        inner = halfedge->twin;
+    }
+    // Defining current setup
+    twin = inner->twin;
+    HalfEdge *tr = inner->next;
+    HalfEdge *tl = tr->next;
+
+    HalfVertex *p = twin->vertex;
+    HalfVertex *r = tl->vertex;
+
+    HalfFace *f1 = inner->face;
+
+    new_vertex->index = -1;
+
+    // Setting up triangles
+    HalfEdge *a = edges[0];
+    HalfEdge *b = edges[1];
+    HalfEdge *c = edges[2];
+    HalfEdge *d = edges[3];
+
+    HalfFace *f2 = face;
+
+    change_edge(a, tl, b, new_vertex, f1);
+    change_edge(b, c, a, r, f2);
+    change_edge(c, tr, d, new_vertex, f2);
+    change_edge(d, twin, c, p, nullptr);
+
+    change_edge(inner, a, nullptr, nullptr, nullptr);
+    change_edge(twin, nullptr, nullptr, new_vertex, nullptr);
+    change_edge(tr, b, nullptr, nullptr, f2);
+
+    change_vertex(new_vertex, a);
+    change_vertex(p, tr);
+
+    change_face(f1, inner);
+    change_face(f2, b);
+
+    // Connecting prev edge to d
+    twin->prev->next = d;
+    d->prev = twin->prev;
+    twin->prev = d;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::change_edge(
+    HalfEdge* halfedge,
+    HalfEdge *next,
+    HalfEdge *twin,
+    HalfVertex *vertex, 
+    HalfFace *face
+) {
+    /**
+     * Changes halfedge's fields according to inputs
+     * If a param is nullptr, it will be ignored
+     */
+    if (next) halfedge->next = next;
+    if (twin) halfedge->twin = twin;
+    if (vertex) halfedge->vertex = vertex;
+    if (face) halfedge->face = face;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::change_face(HalfFace *face, HalfEdge *halfedge) {
+    /**
+     * Changes halfedge's field according to input
+     */
+    if (halfedge) face->edge = halfedge;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::change_vertex(HalfVertex *vertex, HalfEdge *halfedge) {
+    /**
+     * Changes vertex's fields according to inputs
+     */
+    if (halfedge) vertex->edge = halfedge;
+}
+
+/**
+ * COLLAPSE
+ */
+template<typename Field>
+int
+BasicRemesher3d<Field>::collapse_edges() {
+    /**
+     * Performs collapse on short edges
+     */
+    if (_compact_core) return collapse_compact_edges();
+
+    // Collapse validation reads the cached one-rings
+    flux_assert(_adjacency.is_built());
+    if (_parallel_collapse) return collapse_edges_in_parallel();
+    if (_priority_scheduling) return collapse_edges_by_priority();
+
+    int num_collapses = 0;
+    std::vector<HalfEdge*> edges_to_remove;
+    std::set<HalfEdge*> removed_edges;
+
+    update_halfedge_vector();
+    measure_targets(_halfedge_vector);
+
+    for (int i = 0; i < (int) _halfedge_vector.size(); ++i) {
+        HalfEdge *halfedge = _halfedge_vector[i];
+        if (check_if_edge_is_removed(halfedge, removed_edges)) continue;
+        if (check_collapse(halfedge, i)) {
+            edges_to_remove = collapse(halfedge);
+
+            // Collapses wasn't performed to to negative area
+            if (!edges_to_remove.size()) continue;
+
+            num_collapses++;
+            add_removed_edges(removed_edges, edges_to_remove);
+        }
+    }
+    _touched_vertices.clear();
+    return num_collapses;
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::collapse_edges_by_priority() {
+    /**
+     * Performs collapses from the shortest edge (relative to its target length)
+     * up. Both halfedges of an edge are queued since the collapse direction
+     * decides which vertex survives
+     */
+    int num_collapses = 0;
+    HalfEdge *halfedge;
+    double ratio;
+
+    _collapse_queue.clear();
+    _touched_vertices.clear();
+    update_halfedge_vector();
+
+    for (auto& e : _halfedge_vector) {
+        queue_collapse(e);
+    }
+
+    while (_collapse_queue.pop(halfedge, ratio)) {
+        if (!check_collapse(halfedge)) continue;
+
+        // Collapses wasn't performed to to negative area
+        if (!collapse(halfedge).size()) continue;
+        num_collapses++;
+
+        for (int v : _touched_vertices) _collapse_queue.touch(v);
+        for (int v : _touched_vertices) {
+            if (!_adjacency.vertex(v)) continue;
+            get_outgoing_edges(_adjacency.vertex(v), _edge_onering);
+            for (HalfEdge *e : _edge_onering) {
+                queue_collapse(e);
+                queue_collapse(e->twin);
+            }
+        }
+        _touched_vertices.clear();
+    }
+
+    return num_collapses;
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::collapse_edges_in_parallel() {
+    /**
+     * Performs collapses in rounds. Each round keeps the candidates that pass
+     * check_collapse, picks among them a randomized maximal independent set so
+     * that no two chosen collapses share a vertex of their regions (p, q and
+     * their one-rings), and applies those concurrently. Losers and the edges
+     * around touched vertices become the next round's candidates. Removed
+     * elements are only marked dead and erased in one pass at the end, unless
+     * _pool keeps them for later splits or compact() erases them
+     */
+    int num_collapses = 0;
+    std::vector<int> touched_round(_adjacency.nb_vertices(), -1);
+    std::vector<HalfEdge*> candidates, next_candidates;
+    std::vector<char> status;
+    std::vector<HalfEdge*> removed;
+    std::unordered_set<HalfEdge*> queued;
+
+    _touched_vertices.clear();
+    update_halfedge_vector();
+    candidates = _halfedge_vector;
+
+    for (int round = 0; !candidates.empty(); ++round) {
+        int num_candidates = candidates.size();
+        status.assign(num_candidates, 0);
+
+        // Keeping the candidates that can be collapsed now
+        measure_targets(candidates);
+        parallel_for(num_candidates, _num_threads, [&](int, int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                status[i] = check_collapse(candidates[i], i);
+            }
+        });
+
+        int num_valid = 0;
+        for (int i = 0; i < num_candidates; ++i) {
+            if (status[i]) candidates[num_valid++] = candidates[i];
+        }
+        candidates.resize(num_valid);
+        if (!num_valid) break;
+
+        // Picking collapses with disjoint regions
+        select_independent_set(candidates, round, COLLAPSE_REGION, status);
+        removed.assign(4 * num_valid, nullptr);
+
+        // Winners are collapsed concurrently. One that would create negative
+        // area is dropped
+        parallel_for(num_valid, _num_threads, [&](int, int begin, int end) {
+            std::vector<HalfEdge*> p_edges;
+            std::vector<HalfEdge*> edges_to_remove;
+
+            for (int i = begin; i < end; ++i) {
+                if (!status[i]) continue;
+
+                status[i] = 2;
+                if (!rewire_collapse(candidates[i], p_edges, edges_to_remove)) continue;
+
+                status[i] = 1;
+                std::copy(edges_to_remove.begin(), edges_to_remove.end(), &removed[4 * i]);
+            }
+        });
+
+        // Marking removed elements dead and patching one-rings serially
+        std::vector<HalfEdge*> edges_to_remove;
+        for (int i = 0; i < num_valid; ++i) {
+            if (status[i] != 1) continue;
+
+            HalfVertex *q = candidates[i]->vertex;
+            edges_to_remove.assign(&removed[4 * i], &removed[4 * i] + 4);
+            bury_p(candidates[i], edges_to_remove);
+            touch_onering(q);
+            num_collapses++;
+        }
+
+        for (int v : _touched_vertices) {
+            touched_round[v] = round;
+        }
+
+        // Losers survive unless a winner touched (and maybe removed) their edge
+        next_candidates.clear();
+        queued.clear();
+        for (int i = 0; i < num_valid; ++i) {
+            HalfEdge *halfedge = candidates[i];
+            if (status[i] || is_dead(halfedge)) continue;
+            if (touched_round[_adjacency.index(halfedge->vertex)] == round) continue;
+            if (touched_round[_adjacency.index(halfedge->twin->vertex)] == round) continue;
+            if (queued.insert(halfedge).second) next_candidates.push_back(halfedge);
+        }
+
+        for (int v : _touched_vertices) {
+            if (!_adjacency.vertex(v)) continue;
+            get_outgoing_edges(_adjacency.vertex(v), _edge_onering);
+            for (HalfEdge *e : _edge_onering) {
+                if (queued.insert(e).second) next_candidates.push_back(e);
+                if (queued.insert(e->twin).second) next_candidates.push_back(e->twin);
+            }
+        }
+        _touched_vertices.clear();
+
+        candidates.swap(next_candidates);
+    }
+
+    if (!_element_pool && !_deferred_deletion) erase_dead(_halfmesh);
+    return num_collapses;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::queue_collapse(HalfEdge *halfedge) {
+    /**
+     * Adds halfedge to _collapse_queue if it is short enough to be collapsed
+     */
+    double ratio = get_ratio(halfedge);
+    if (ratio >= sqrt(2)/2.0) return;
+
+    _collapse_queue.push(
+        halfedge,
+        _adjacency.index(halfedge->vertex),
+        _adjacency.index(halfedge->twin->vertex),
+        ratio
+    );
+}
+
+template<typename Field>
+std::vector<HalfEdge*>
+BasicRemesher3d<Field>::collapse(HalfEdge *halfedge) {
+    /**
+     * Collapses halfedge. q will be the receiver in this implementation
+     * 
+     * PARAMS:
+     * halfedge_mesh: smart pointer to the mesh
+     * halfedge:      pointer to the HalfEdge that is to be collapsed
+     * 
+     * returns a vector of halfedges that need to be removed from priorityqueue 
+     * and mesh itself
+     */
+    HalfVertex *q = halfedge->vertex;
+
+    std::vector<HalfEdge*> edges_to_remove;
+    if (!rewire_collapse(halfedge, _edge_onering, edges_to_remove)) {
+        return edges_to_remove;
+    }
+    remove_p(halfedge, edges_to_remove);
+
+    // Patching one-rings of q and everything around it (p's old neighbours)
+    touch_onering(q);
+
+    return edges_to_remove;
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::rewire_collapse(
+    HalfEdge *halfedge,
+    std::vector<HalfEdge*>& p_edges,
+    std::vector<HalfEdge*>& edges_to_remove
+) {
+    /**
+     * Moves q onto p and reconnects everything around p to q. p, the two faces
+     * of halfedge and the halfedges c and d (plus twins) are left disconnected
+     * but not deleted. Only elements inside the one-rings of p and q are read
+     * or written, and the cached one-rings are only read
+     *
+     * PARAMS:
+     * halfedge:        pointer to the HalfEdge that is to be collapsed
+     * p_edges:         scratch space for the halfedges leaving p
+     * edges_to_remove: receives c, c's twin, d and d's twin
+     *
+     * RETURNS: 0 if the collapse is not valid (mesh left unchanged)
+     */
+    HalfVertex *q = halfedge->vertex;
+    HalfVertex *p = halfedge->twin->vertex;
+
+    vec3d original_q_coord = q->point;
+
+    q->point = p->point;
+
+    // Check. If collapse not valid, return an empty vector
+    HalfFace *f0 = halfedge->face;
+    HalfFace *f1 = halfedge->twin->face;
+
+    // Check if collapse is not valid --> return an empty vector
+    int invalid = _normal_flip_check
+        ? check_normal_flip_ignore_faces(_adjacency.index(q), original_q_coord, f0, f1)
+        : check_negative_area_ignore_faces(_adjacency.index(q), f0, f1);
+    if (invalid) {
+        q->point = original_q_coord;
+        return 0;
+    }
+
+    // Gathering the halfedges leaving p from its incident faces
+    int p_index = _adjacency.index(p);
+    const int *p_faces = _adjacency.incident_faces(p_index);
+    p_edges.clear();
+    for (int i = 0; i < _adjacency.nb_incident_faces(p_index); ++i) {
+        HalfEdge *e = _adjacency.face(p_faces[i])->edge;
+        while (e->vertex != p) e = e->next;
+        p_edges.push_back(e);
+    }
+
+    // Take onering of p and point all edges' vertex except halfedge's tp q
+    point_edges_to_q(p_edges, q, p);
+
+    // Update q connectivity and move it to the position of p
+    q->edge = halfedge->twin->next;
+
+    // Connect the two triangles, bridging the gap as seen in our drawing
+    edges_to_remove = connect_triangles(halfedge);
+    return 1;
+}
+
+template<typename Field>
+std::vector<HalfEdge*>
+BasicRemesher3d<Field>::connect_triangles(HalfEdge *halfedge) {
+    /**
+     * Connects the triangles, bridging the gap that was created by removing p
+     * 
+     * PARAMS:
+     * halfedge: pointer to the HalfEdge that is being removed
+     * 
+     * returns a vector of 2 halfedges that need to be removed
+     */
+    HalfEdge *a = halfedge->next->next; // Replaces c
+    HalfEdge *b = halfedge->twin->next; // Replaces d
+    HalfEdge *c = halfedge->next->twin; // Removing
+    HalfEdge *d = b->next->twin;        // Removing
+
+    // Connect a to triangle
+    a->next = c->next;
+    a->face = c->face;
+
+    // Connect c's previous edge and face to a
+    c->next->next->next = a;
+    c->face->edge = a;
+
+    //Connect b to triangle
+    b->next = d->next;
+    b->face = d->face;
+
+    // Connect d's previous edge and face to b
+    d->next->next->next = b;
+    d->face->edge = b;
+
+    // Update vertex's edge for c and d just in case
+    c->vertex->edge = a;
+    d->twin->vertex->edge = b->next;
+
+    HalfEdge *c_twin = c->twin;
+    HalfEdge *d_twin = d->twin;
+    std::vector<HalfEdge*> edges_to_remove({c, c_twin, d, d_twin});
+
+    return edges_to_remove;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::remove_p(HalfEdge *halfedge, std::vector<HalfEdge*>& edges_to_remove) {
+    /**
+     * Removes HalfVertex p and the affected half edges p affects
+     * 
+     * PARAMS:
+     * halfedge_mesh: smart pointer to halfedge_mesh that p is being removed from
+     * halfedge: halfedge that is being removed
+     * edges_to_remove: the edges c and d that are also being removed
+     */
+
+    if (_element_pool || _deferred_deletion) {
+        bury_p(halfedge, edges_to_remove);
+        return;
+    }
+
+    forget_p(halfedge);
+
+    // Remove faces from mesh
+    _halfmesh.remove(halfedge->face);
+    _halfmesh.remove(halfedge->twin->face);
+
+    HalfEdge *twin = halfedge->twin;
+    HalfVertex *p = twin->vertex;
+
+    // Remove original halfedge and twin
+    _halfmesh.remove(halfedge);
+    _halfmesh.remove(twin);
+
+    // Remove c and d plus their twins
+    for (auto& e : edges_to_remove) {
+        _halfmesh.remove(e);
+    }
+
+    // Add halfedge and twin to edges_to_remove so we can add them to set
+    edges_to_remove.push_back(halfedge);
+    edges_to_remove.push_back(twin);
+
+    flux_assert(edges_to_remove.size() == 6);
+
+    _halfmesh.remove(p);
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::bury_p(HalfEdge *halfedge, std::vector<HalfEdge*>& edges_to_remove) {
+    /**
+     * Same as remove_p, but only marks p, the two faces and the six halfedges
+     * as dead. They are erased later by erase_dead() or recycled by _pool
+     */
+    forget_p(halfedge);
+
+    HalfEdge *twin = halfedge->twin;
+    HalfVertex *p = twin->vertex;
+
+    discard(halfedge->face);
+    discard(twin->face);
+    discard(p);
+
+    edges_to_remove.push_back(halfedge);
+    edges_to_remove.push_back(twin);
+    flux_assert(edges_to_remove.size() == 6);
+
+    for (auto& e : edges_to_remove) {
+        discard(e);
+    }
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::forget_p(HalfEdge *halfedge) {
+    /**
+     * Drops p and the two faces of halfedge from the cached one-rings, before
+     * they are deleted
+     */
+    _touched_vertices.push_back(_adjacency.index(halfedge->twin->vertex));
+    _churn++;
+    _adjacency.remove(halfedge->face);
+    _adjacency.remove(halfedge->twin->face);
+    _adjacency.remove(halfedge->twin->vertex);
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::check_if_edge_is_removed(
+    HalfEdge *halfedge, 
+    std::set<HalfEdge*>& removed_edges
+) {
+    /**
+     * Check if edge has already been removed in a previous collapse
+     */
+    if (removed_edges.find(halfedge) != removed_edges.end()) return 1;
+    return 0;
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::check_collapse(HalfEdge *halfedge, int slot) {
+    /**
+     * Checks if halfedge is valid for a collapse operation. slot, if >= 0, is
+     * the position of halfedge in the last measure_targets() call
+     */
+    if (is_boundary_edge(halfedge) || has_boundary_vertex(halfedge)) return 0;
+    if (!check_link_condition(halfedge)) return 0;
+
+    double length = get_length(halfedge);
+    vec3d midpoint_vec = calculate_middle(halfedge);
+
+    double analytical_length = get_target(midpoint_vec, slot);
+    double ratio = length / analytical_length;
+
+    if (ratio < (sqrt(2)/2.0)) return 1;
+    return 0;
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::check_link_condition(HalfEdge *halfedge) {
+    /**
+     * Checks that the endpoints of halfedge share exactly the two vertices
+     * opposite to it. Collapsing an edge whose endpoints share more neighbours
+     * would pinch the surface into non-manifold edges
+     */
+    int q = _adjacency.index(halfedge->vertex);
+    int p = _adjacency.index(halfedge->twin->vertex);
+    const int *q_onering = _adjacency.neighbours(q);
+    const int *p_onering = _adjacency.neighbours(p);
+
+    int num_common = 0;
+    for (int i = 0; i < _adjacency.valence(q); ++i) {
+        for (int j = 0; j < _adjacency.valence(p); ++j) {
+            if (q_onering[i] == p_onering[j]) num_common++;
+        }
+    }
+    return num_common == 2;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::point_edges_to_q(
+    std::vector<HalfEdge*>& p_onering,
+    HalfVertex *q,
+    HalfVertex *p
+) {
+    /**
+     * Takes all the HalfEdges that are based at p and points them towards q. 
+     * This function makes sure to ignore the HalfVertex that is being removed.
+     * 
+     * PARAMS:
+     * p_onering: Smart pointer to the onering of p that contains all the HalfEdges
+     *            affected by p's removal
+     * p:         Pointer to the HalfVertex that is being removed
+     * q:         Pointer to the receiving HalfVertex
+     */
+    // Loop thru onering, reorienting HalfEdges
+    for (auto& e: p_onering) {
+        if (e->vertex == p) {
+            if (e->next->vertex == q) { // Check for HalfEdge being removed
+                continue;
+            }
+            e->vertex = q;
+        }
+    }
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::check_negative_area_ignore_faces(
+    int vertex,
+    HalfFace *f0,
+    HalfFace *f1
+) {
+    /**
+     * Checks if negative area was created with this smooth in the faces around
+     * vertex
+     */
+    HalfEdge *start_edge;
+    HalfVertex *v0, *v1, *v2;
+    vec3d p0, p1, p2;
+
+    const int *face_onering = _adjacency.incident_faces(vertex);
+    for (int i = 0; i < _adjacency.nb_incident_faces(vertex); ++i) {
+        HalfFace *face = _adjacency.face(face_onering[i]);
+
+        // Ignore face if it is one that will be collapsed
+        if (face == f0 || face == f1) continue;
+
+        // Getting vertices of triangle
+        start_edge = face->edge;
+        v0 = start_edge->vertex;
+        v1 = start_edge->next->vertex;
+        v2 = start_edge->next->next->vertex;
+
+        // Getting their coordinates
+        p0 = v0->point;
+        p1 = v1->point;
+        p2 = v2->point;
+        const double *center;
+        double center_coords[3] = {0.0, 0.0, 0.0};
+        center = center_coords;
+
+        if (orient3d(p0.data(), p1.data(), p2.data(), center) <= 0) return 1;
+    }
+    return 0;
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::check_normal_flip_ignore_faces(
+    int vertex,
+    const vec3d& old_point,
+    HalfFace *f0,
+    HalfFace *f1
+) {
+    /**
+     * Checks if moving vertex from old_point to where it is now flips the
+     * normal of one of its faces
+     */
+    const int *face_onering = _adjacency.incident_faces(vertex);
+    for (int i = 0; i < _adjacency.nb_incident_faces(vertex); ++i) {
+        int f = face_onering[i];
+        HalfFace *face = _adjacency.face(f);
+
+        // Ignore face if it is one that will be collapsed
+        if (face == f0 || face == f1) continue;
+
+        // Other two corners, in the face's order starting after vertex
+        const int *triangle = _adjacency.triangle(f);
+        int corner = (triangle[0] == vertex) ? 0 : (triangle[1] == vertex) ? 1 : 2;
+        HalfVertex *u = _adjacency.vertex(triangle[(corner + 1) % 3]);
+        HalfVertex *w = _adjacency.vertex(triangle[(corner + 2) % 3]);
+
+        if (check_normal_flip(old_point.data(), _adjacency.vertex(vertex)->point.data(),
+            u->point.data(), w->point.data())) return 1;
+    }
+    return 0;
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::check_normal_flip(
+    const double *old_point,
+    const double *new_point,
+    const double *u,
+    const double *w
+) {
+    /**
+     * Checks if triangle (q, u, w) gets a normal at 90 degrees or more from its
+     * old one when q moves from old_point to new_point. The dot product of the
+     * two normals is computed in floating point first, and only when it is
+     * within its rounding error bound of 0 is it evaluated exactly
+     */
+    double a0[3], b0[3], a1[3], b1[3];
+    for (int d = 0; d < 3; ++d) {
+        a0[d] = u[d] - old_point[d];
+        b0[d] = w[d] - old_point[d];
+        a1[d] = u[d] - new_point[d];
+        b1[d] = w[d] - new_point[d];
+    }
+
+    double dot = 0.0, permanent = 0.0;
+    for (int i = 0; i < 3; ++i) {
+        int j = (i + 1) % 3, k = (i + 2) % 3;
+        double n0 = a0[j] * b0[k] - a0[k] * b0[j];
+        double n1 = a1[j] * b1[k] - a1[k] * b1[j];
+
+        dot += n0 * n1;
+        permanent += (fabs(a0[j] * b0[k]) + fabs(a0[k] * b0[j]))
+            * (fabs(a1[j] * b1[k]) + fabs(a1[k] * b1[j]));
+    }
+
+    // Differences, products and sums each add at most a few ulps
+    const double error_bound = 16.0 * std::numeric_limits<double>::epsilon();
+    if (dot > error_bound * permanent) return 0;
+    if (dot < -error_bound * permanent) return 1;
+
+    return normal_dot_sign(old_point, new_point, u, w) <= 0;
+}
+
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::add_removed_edges(
+    std::set<HalfEdge*>& removed_edges,
+    std::vector<HalfEdge*>& edges_to_remove
+) {
+    /**
+     * Insert edges that have been removed into set
+     */
+    for (auto& halfedge : edges_to_remove) {
+        removed_edges.insert(halfedge);
+    }
+}
+
+/**
+ * PROJECT TO SURFACE
+ */
+template<typename Field>
+void
+BasicRemesher3d<Field>::project_to_surface() {
+    /**
+     * Snaps every vertex in _adjacency to its closest point on _reference.
+     * The BVH is built on first use
+     */
+    if (_compact_core) return project_compact_to_surface();
+    flux_assert(_adjacency.is_built());
+    if (!_reference.is_built()) _reference.build();
+
+    parallel_for(_adjacency.nb_vertices(), _num_threads, [&](int, int begin, int end) {
+        for (int v = begin; v < end; ++v) {
+            HalfVertex *vertex = _adjacency.vertex(v);
+            if (!vertex) continue;
+            vertex->point = _reference.closest_point(vertex->point);
+        }
+    });
+}
+
+/**
+ * COMPACT CORE
+ */
+template<typename Field>
+std::pair<int,int>
+BasicRemesher3d<Field>::split_compact_edges() {
+    /**
+     * Linear split sweep over the edges of _compact. Faces added by the sweep
+     * are visited in the next pass
+     */
+    int num_splits = 0, num_boundary_splits = 0;
+    std::vector<CompactMesh::index_t> halfedges;
+    collect_compact_edges(halfedges);
+    measure_compact_targets(halfedges);
+
+    for (int i = 0; i < (int) halfedges.size(); ++i) {
+        CompactMesh::index_t halfedge = halfedges[i];
+        int split = check_compact_split(halfedge, i);
+        if (!split) continue;
+
+        vec3d midpoint_vec = calculate_compact_middle(halfedge);
+        _compact.split(halfedge, midpoint_vec.data());
+        if (split == 2) {
+            num_boundary_splits++;
+        } else {
+            num_splits++;
+        }
+    }
+
+    return std::make_pair(num_splits, num_boundary_splits);
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::collapse_compact_edges() {
+    /**
+     * Linear collapse sweep over the edges of _compact. Halfedges whose face
+     * an earlier collapse removed are skipped. Like the pointer core, which
+     * sweeps both halfedges of an edge, the edge is collapsed the other way
+     * round when moving q onto p would flip a face
+     */
+    int num_collapses = 0;
+    std::vector<CompactMesh::index_t> halfedges;
+    collect_compact_edges(halfedges);
+    measure_compact_targets(halfedges);
+
+    for (int i = 0; i < (int) halfedges.size(); ++i) {
+        CompactMesh::index_t halfedge = halfedges[i];
+        if (_compact.is_dead_face(CompactMesh::face(halfedge))) continue;
+        if (!check_compact_collapse(halfedge, i)) continue;
+        if (!check_compact_collapse_faces(halfedge)) {
+            halfedge = _compact.twin(halfedge);
+            if (!check_compact_collapse_faces(halfedge)) continue;
+        }
+
+        _compact.collapse(halfedge);
+        num_collapses++;
+    }
+
+    return num_collapses;
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::flip_compact_edges() {
+    /**
+     * Linear flip sweep over the edges of _compact
+     */
+    int num_flips = 0;
+    std::vector<CompactMesh::index_t> halfedges;
+    collect_compact_edges(halfedges);
+
+    for (CompactMesh::index_t halfedge : halfedges) {
+        if (!check_compact_flip(halfedge)) continue;
+
+        _compact.flip(halfedge);
+        num_flips++;
+    }
+
+    return num_flips;
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::project_compact_to_surface() {
+    /**
+     * Snaps every vertex of _compact to its closest point on _reference
+     */
+    if (!_reference.is_built()) _reference.build();
+
+    parallel_for(_compact.nb_vertices(), _num_threads, [&](int, int begin, int end) {
+        for (int v = begin; v < end; ++v) {
+            if (_compact.is_dead_vertex(v)) continue;
+
+            double *point = _compact.point(v);
+            vec3d point_vec;
+            for (int d = 0; d < 3; ++d) point_vec[d] = point[d];
+
+            vec3d closest = _reference.closest_point(point_vec);
+            for (int d = 0; d < 3; ++d) point[d] = closest[d];
+        }
+    });
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::collect_compact_edges(std::vector<CompactMesh::index_t>& halfedges) {
+    /**
+     * Collects one live halfedge per edge of _compact, in id order
+     */
+    halfedges.clear();
+    for (CompactMesh::index_t h = 0; h < _compact.nb_halfedges(); ++h) {
+        if (_compact.is_dead_face(CompactMesh::face(h))) continue;
+        if (_compact.twin(h) >= 0 && _compact.twin(h) < h) continue;
+        halfedges.push_back(h);
+    }
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::measure_compact_ratios(std::vector<double>& ratios) {
+    /**
+     * Length/target ratio of every edge of _compact, unsorted
+     */
+    std::vector<CompactMesh::index_t> halfedges;
+    collect_compact_edges(halfedges);
+    measure_compact_targets(halfedges);
+
+    ratios.resize(halfedges.size());
+    parallel_for(halfedges.size(), _num_threads, [&](int, int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            CompactMesh::index_t h = halfedges[i];
+            ratios[i] = get_length(_compact.point(_compact.vertex(h)),
+                _compact.point(_compact.head(h))) / _targets[i];
+        }
+    });
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::measure_compact_targets(const std::vector<CompactMesh::index_t>& halfedges) {
+    /**
+     * measure_targets() for halfedges of _compact
+     */
+    int num_edges = halfedges.size();
+    if (_constant_size) {
+        _targets.assign(num_edges, _constant_target);
+        return;
+    }
+
+    _midpoints.resize(3 * num_edges);
+    _targets.resize(num_edges);
+    parallel_for(num_edges, _num_threads, [&](int, int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            vec3d midpoint = calculate_compact_middle(halfedges[i]);
+            std::copy(midpoint.data(), midpoint.data() + 3, &_midpoints[3 * i]);
+        }
+    });
+
+    evaluate_targets(num_edges);
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::check_compact_split(CompactMesh::index_t halfedge, int slot) {
+    /**
+     * check_split() for a halfedge of _compact
+     *
+     * RETURNS: 0 for no split, 1 for an interior split, 2 for a boundary split
+     */
+    CompactMesh::index_t twin = _compact.twin(halfedge);
+    double length = get_length(_compact.point(_compact.vertex(halfedge)),
+        _compact.point(_compact.head(halfedge)));
+
+    vec3d midpoint_vec = calculate_compact_middle(halfedge);
+    double analytical_length = get_target(midpoint_vec, slot);
+
+    if (length / analytical_length < sqrt(2)) return 0;     // no split
+
+    // Short edge creation check, towards the corners opposite halfedge
+    CompactMesh::index_t opposite[2] = {CompactMesh::prev(halfedge), -1};
+    if (twin >= 0) opposite[1] = CompactMesh::prev(twin);
+    for (CompactMesh::index_t h : opposite) {
+        if (h < 0) continue;
+
+        // Same metric as the length of halfedge itself
+        const double *corner = _compact.point(_compact.vertex(h));
+        if (get_length(corner, midpoint_vec.data()) / analytical_length < 0.6) return 0;
+    }
+
+    return (twin < 0) ? 2 : 1;
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::check_compact_collapse(CompactMesh::index_t halfedge, int slot) {
+    /**
+     * check_collapse() for a halfedge of _compact: the same for both
+     * directions of the edge, the cheap length test before the link condition
+     */
+    CompactMesh::index_t twin = _compact.twin(halfedge);
+    if (twin < 0) return 0;
+
+    CompactMesh::index_t q = _compact.vertex(halfedge);
+    CompactMesh::index_t p = _compact.head(halfedge);
+    if (_compact.is_boundary_vertex(q) || _compact.is_boundary_vertex(p)) return 0;
+
+    double length = get_length(_compact.point(q), _compact.point(p));
+    vec3d midpoint_vec = calculate_compact_middle(halfedge);
+
+    double analytical_length = get_target(midpoint_vec, slot);
+    if (length / analytical_length >= (sqrt(2)/2.0)) return 0;
+
+    return check_compact_link_condition(halfedge);
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::check_compact_collapse_faces(CompactMesh::index_t halfedge) {
+    /**
+     * The test rewire_collapse() makes on the faces around q once it sits on
+     * p, for a halfedge of _compact that passed check_compact_collapse()
+     */
+    CompactMesh::index_t twin = _compact.twin(halfedge);
+    CompactMesh::index_t q = _compact.vertex(halfedge);
+    const double *q_point = _compact.point(q);
+    const double *p_point = _compact.point(_compact.head(halfedge));
+
+    // Faces around q other than the two removed ones, with q moved onto p
+    const double origin[3] = {0.0, 0.0, 0.0};
+    _compact.get_outgoing(q, _compact_ring);
+    for (CompactMesh::index_t h : _compact_ring) {
+        CompactMesh::index_t face = CompactMesh::face(h);
+        if (face == CompactMesh::face(halfedge) || face == CompactMesh::face(twin)) continue;
+
+        const double *u = _compact.point(_compact.head(h));
+        const double *w = _compact.point(_compact.vertex(CompactMesh::prev(h)));
+        int invalid = _normal_flip_check
+            ? check_normal_flip(q_point, p_point, u, w)
+            : orient3d(p_point, u, w, origin) <= 0;
+        if (invalid) return 0;
+    }
+    return 1;
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::check_compact_link_condition(CompactMesh::index_t halfedge) {
+    /**
+     * check_link_condition() for a halfedge of _compact
+     */
+    _compact.get_onering(_compact.vertex(halfedge), _compact_ring);
+    _compact.get_onering(_compact.head(halfedge), _compact_other_ring);
+
+    int num_common = 0;
+    for (CompactMesh::index_t u : _compact_ring) {
+        for (CompactMesh::index_t w : _compact_other_ring) {
+            if (u == w) num_common++;
+        }
+    }
+    return num_common == 2;
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::check_compact_flip(CompactMesh::index_t halfedge) {
+    /**
+     * check_flip() for a halfedge of _compact
+     */
+    CompactMesh::index_t twin = _compact.twin(halfedge);
+    if (twin < 0) return 0;
+
+    CompactMesh::index_t q = _compact.vertex(halfedge);
+    CompactMesh::index_t p = _compact.vertex(twin);
+    CompactMesh::index_t r = _compact.vertex(CompactMesh::prev(halfedge));
+    CompactMesh::index_t s = _compact.vertex(CompactMesh::prev(twin));
+    if (r == s) return 0;
+
+    // r and s must not be connected already, and q and p keep at least 3 edges
+    _compact.get_onering(r, _compact_ring);
+    for (CompactMesh::index_t u : _compact_ring) {
+        if (u == s) return 0;
+    }
+
+    int valences[4] = {_compact.valence(q), _compact.valence(p), (int) _compact_ring.size(),
+        _compact.valence(s)};
+    if (valences[0] <= 3 || valences[1] <= 3) return 0;
+
+    CompactMesh::index_t vertices[4] = {q, p, r, s};
+    int deviations[4];
+    for (int i = 0; i < 4; ++i) {
+        deviations[i] = valences[i] - (_compact.is_boundary_vertex(vertices[i]) ? 4 : 6);
+    }
+    if (!improves_valences(deviations[0], deviations[1], deviations[2], deviations[3])) return 0;
+
+    return check_flip_normals(_compact.point(q), _compact.point(p), _compact.point(r),
+        _compact.point(s));
+}
+
+template<typename Field>
+vec3d
+BasicRemesher3d<Field>::calculate_compact_middle(CompactMesh::index_t halfedge) {
+    /**
+     * calculate_middle() for a halfedge of _compact
+     */
+    const double *v1_point = _compact.point(_compact.vertex(halfedge));
+    const double *v2_point = _compact.point(_compact.head(halfedge));
+
+    vec3d result_coords;
+    for (int i = 0; i < 3; ++i) result_coords[i] = (v1_point[i] + v2_point[i]) / 2.0;
+    return result_coords;
+}
+
+/**
+ * PARALLEL SCHEDULING
+ */
+template<typename Field>
+void
+BasicRemesher3d<Field>::select_independent_set(
+    std::vector<HalfEdge*>& candidates,
+    int round,
+    Region region,
+    std::vector<char>& selected
+) {
+    /**
+     * One step of a randomized maximal independent set (Luby). Every candidate
+     * writes a random key into the vertices of its region keeping the max, and
+     * candidates holding their whole region afterwards are selected. Selected
+     * candidates never share a region vertex, and the largest key always wins,
+     * so repeating rounds on the leftovers covers every candidate
+     *
+     * PARAMS:
+     * candidates: halfedges competing in this round
+     * round:      round number, seeds the keys
+     * region:     which vertices an operation on a halfedge reads or writes
+     * selected:   set to 1 for selected candidates, 0 otherwise
+     */
+    int num_candidates = candidates.size();
+    int num_vertices = _adjacency.nb_vertices();
+    std::vector<std::atomic<unsigned long long>> claims(num_vertices);
+
+    parallel_for(num_vertices, _num_threads, [&](int, int begin, int end) {
+        for (int v = begin; v < end; ++v) {
+            claims[v].store(0, std::memory_order_relaxed);
+        }
+    });
+
+    parallel_for(num_candidates, _num_threads, [&](int, int begin, int end) {
+        std::vector<int> vertices;
+        for (int i = begin; i < end; ++i) {
+            unsigned long long key = round_key(round, i);
+            get_region(candidates[i], region, vertices);
+
+            for (int v : vertices) {
+                unsigned long long current = claims[v].load(std::memory_order_relaxed);
+                while (current < key && !claims[v].compare_exchange_weak(current, key)) {}
+            }
+        }
+    });
+
+    // Decided for all candidates before any of them changes the mesh
+    selected.assign(num_candidates, 0);
+    parallel_for(num_candidates, _num_threads, [&](int, int begin, int end) {
+        std::vector<int> vertices;
+        for (int i = begin; i < end; ++i) {
+            unsigned long long key = round_key(round, i);
+            get_region(candidates[i], region, vertices);
+
+            selected[i] = 1;
+            for (int v : vertices) {
+                if (claims[v].load(std::memory_order_relaxed) != key) selected[i] = 0;
+            }
+        }
+    });
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::get_region(HalfEdge *halfedge, Region region, std::vector<int>& vertices) {
+    /**
+     * Collects the ids of the vertices whose elements an operation on halfedge
+     * reads or writes
+     *
+     * COLLAPSE_REGION: p, q and both one-rings
+     * SPLIT_REGION:    p, q and the vertices opposite halfedge in its faces
+     * FLIP_REGION:     same as SPLIT_REGION
+     */
+    int q = _adjacency.index(halfedge->vertex);
+    int p = _adjacency.index(halfedge->twin->vertex);
+    vertices.clear();
+    vertices.push_back(q);
+    vertices.push_back(p);
+
+    switch (region) {
+        case COLLAPSE_REGION:
+            vertices.insert(vertices.end(), _adjacency.neighbours(q),
+                _adjacency.neighbours(q) + _adjacency.valence(q));
+            vertices.insert(vertices.end(), _adjacency.neighbours(p),
+                _adjacency.neighbours(p) + _adjacency.valence(p));
+            break;
+        case SPLIT_REGION:
+        case FLIP_REGION:
+            if (halfedge->face) {
+                vertices.push_back(_adjacency.index(halfedge->next->next->vertex));
+            }
+            if (halfedge->twin->face) {
+                vertices.push_back(_adjacency.index(halfedge->twin->next->next->vertex));
+            }
+            break;
+    }
+}
+
+template<typename Field>
+unsigned long long
+BasicRemesher3d<Field>::round_key(int round, int candidate) {
+    /**
+     * Random but reproducible priority of a candidate in a round. The low bits
+     * hold the candidate itself so keys are unique and never 0
+     */
+    unsigned long long x = ((unsigned long long) round << 32) + candidate;
+
+    // splitmix64
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    x = x ^ (x >> 31);
+
+    return (x & 0xffffffff00000000ULL) | (unsigned long long) (candidate + 1);
+}
+
+/**
+ * HELPER METHODS
+ */
+template<typename Field>
+void
+BasicRemesher3d<Field>::update_halfedge_vector() {
+    /**
+     * Clears halfedge_vector and then adds current halfedges from halfmesh_ into
+     * halfedge_vector. With an active set, only the halfedges leaving or
+     * entering active vertices are added, in vertex id order
+     */
+    _halfedge_vector.clear();
+    if (_active_set && !_active_vertices.empty()) {
+        std::unordered_set<HalfEdge*> added;
+        for (int v = 0; v < (int) _active_vertices.size(); ++v) {
+            if (!_active_vertices[v] || !_adjacency.vertex(v)) continue;
+
+            get_outgoing_edges(_adjacency.vertex(v), _edge_onering);
+            for (HalfEdge *e : _edge_onering) {
+                if (added.insert(e).second) _halfedge_vector.push_back(e);
+                if (added.insert(e->twin).second) _halfedge_vector.push_back(e->twin);
+            }
+        }
+        return;
+    }
+
+    for (auto& e : _halfmesh.edges()) {
+        if (is_dead(e.get())) continue;
+        _halfedge_vector.push_back(e.get());
+    }
+}
+
+template<typename Field>
+HalfVertex*
+BasicRemesher3d<Field>::create_vertex(const double *point) {
+    /**
+     * Creates a vertex at point, taken from _pool if it is in use
+     */
+    _churn++;
+    if (_element_pool) return _pool.create_vertex(point);
+    return _halfmesh.create_vertex(3, point);
+}
+
+template<typename Field>
+HalfEdge*
+BasicRemesher3d<Field>::create_edge() {
+    if (_element_pool) return _pool.create_edge();
+    return _halfmesh.create_edge();
+}
+
+template<typename Field>
+HalfFace*
+BasicRemesher3d<Field>::create_face() {
+    if (_element_pool) return _pool.create_face();
+    return _halfmesh.create_face();
+}
+
+template<typename Field>
+template<typename Element>
+void
+BasicRemesher3d<Field>::discard(Element *element) {
+    /**
+     * Marks element dead, handing it to _pool if it is in use
+     */
+    if (_element_pool) {
+        _pool.release(element);
+    } else {
+        kill(element);
+    }
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::touch_vertex(HalfVertex *vertex) {
+    /**
+     * Re-derives the cached one-rings of vertex after a local change, if the
+     * cache is in use, and records it in _touched_vertices (and as changed and
+     * active for the active set)
+     */
+    if (!_adjacency.is_built()) return;
+    _adjacency.update(vertex);
+    _color_offsets.clear();
+
+    int v = _adjacency.index(vertex);
+    _touched_vertices.push_back(v);
+
+    if (!_active_set) return;
+    if (v >= (int) _changed_vertices.size()) _changed_vertices.resize(v + 1, 0);
+    _changed_vertices[v] = 1;
+    if (!_active_vertices.empty()) {
+        if (v >= (int) _active_vertices.size()) _active_vertices.resize(v + 1, 0);
+        _active_vertices[v] = 1;
+    }
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::touch_onering(HalfVertex *vertex) {
+    /**
+     * Touches vertex and every vertex in its one-ring
+     */
+    touch_vertex(vertex);
+
+    // Copying the row first, touching appends to the same arrays
+    int v = _adjacency.index(vertex);
+    const int *onering = _adjacency.neighbours(v);
+    _onering_scratch.assign(onering, onering + _adjacency.valence(v));
+    for (int neighbour : _onering_scratch) {
+        touch_vertex(_adjacency.vertex(neighbour));
+    }
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::get_outgoing_edges(HalfVertex *vertex, std::vector<HalfEdge*>& edges) {
+    /**
+     * Collects the halfedges leaving vertex (boundary ones included) by
+     * rotating around it
+     */
+    edges.clear();
+    HalfEdge *halfedge = vertex->edge;
+    do {
+        edges.push_back(halfedge);
+        halfedge = halfedge->twin->next;
+    } while (halfedge != vertex->edge);
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::is_boundary_edge(HalfEdge* halfedge) {
+    /**
+     * Determines if edge is boundary (1) or not (0)
+     */
+    if (!halfedge->face || !halfedge->twin->face) return 1;
+    return 0;
+}
+
+template<typename Field>
+int
+BasicRemesher3d<Field>::has_boundary_vertex(HalfEdge* halfedge) {
+    /**
+     * Checks if either endpoint vertices are boundary
+     */
+    HalfVertex *q = halfedge->vertex;
+    HalfVertex *p = halfedge->twin->vertex;
+
+    if (q->index <=-1 || p->index <=-1) return 1;
+    return 0;
+}
+
+/**
+ * COMPUTATION
+ */
+template<typename Field>
+double
+BasicRemesher3d<Field>::get_length(HalfEdge* halfedge) {
+    /**
+     * Calculates length of a halfedge
+     */
+    return get_length(halfedge->vertex->point.data(), halfedge->twin->vertex->point.data());
+}
+
+template<typename Field>
+double
+BasicRemesher3d<Field>::get_length(const double *a, const double *b) {
+    /**
+     * Calculates length of the edge between points a and b
+     */
+    double dx = a[0] - b[0];
+    double dy = a[1] - b[1];
+    double dz = a[2] - b[2];
+
+    return sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+template<typename Field>
+double
+BasicRemesher3d<Field>::get_ratio(HalfEdge *halfedge) {
+    /**
+     * Calculates length of halfedge relative to the sizing field at its middle
+     */
+    if (_constant_size) return get_length(halfedge) / _constant_target;
+
+    vec3d midpoint_vec = calculate_middle(halfedge);
+    return get_length(halfedge) / get_target(midpoint_vec);
+}
+
+template<typename Field>
+double
+BasicRemesher3d<Field>::get_target(const vec3d& midpoint, int slot) {
+    /**
+     * Target length at midpoint. slot, if >= 0, is a position in the last
+     * measure_targets() call: its target is reused while the midpoint there
+     * is still the same
+     */
+    if (_constant_size) return _constant_target;
+
+    if (slot >= 0) {
+        const double *measured = &_midpoints[3 * slot];
+        if (measured[0] == midpoint[0] && measured[1] == midpoint[1]
+            && measured[2] == midpoint[2]) {
+            return _targets[slot];
+        }
+    }
+    return _sizing_field(midpoint.data());
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::measure_targets(const std::vector<HalfEdge*>& edges) {
+    /**
+     * Evaluates the sizing field at the middle of every edge in one batch,
+     * into _midpoints (xyz triples) and _targets. A constant field skips the
+     * midpoints altogether
+     */
+    int num_edges = edges.size();
+    if (_constant_size) {
+        _targets.assign(num_edges, _constant_target);
+        return;
+    }
+
+    _midpoints.resize(3 * num_edges);
+    _targets.resize(num_edges);
+    parallel_for(num_edges, _num_threads, [&](int, int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            vec3d midpoint = calculate_middle(edges[i]);
+            std::copy(midpoint.data(), midpoint.data() + 3, &_midpoints[3 * i]);
+        }
+    });
+
+    evaluate_targets(num_edges);
+}
+
+template<typename Field>
+void
+BasicRemesher3d<Field>::evaluate_targets(int num_edges) {
+    /**
+     * Evaluates the sizing field at the first num_edges _midpoints, into
+     * _targets (resized already)
+     */
+    if (_batch_sizing_field) {
+        _batch_sizing_field->evaluate(_midpoints.data(), num_edges, _targets.data());
+        return;
+    }
+    parallel_for(num_edges, _num_threads, [&](int, int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            _targets[i] = _sizing_field(&_midpoints[3 * i]);
+        }
+    });
+}
+
+template<typename Field>
+vec3d
+BasicRemesher3d<Field>::calculate_middle(HalfEdge *halfedge) {
+    /**
+     * Calculates the center coordinates of the halfedge
+     *
+     * Returns a array of 2 doubles
+     */
+    vec3d result_coords;
+
+    HalfVertex *v1 = halfedge->vertex;
+    HalfVertex *v2 = halfedge->twin->vertex;
+
+    vec3d v1_point = v1->point;
+    vec3d v2_point = v2->point;
+
+    result_coords[0] = (v1_point[0] + v2_point[0]) / 2.0;
+    result_coords[1] = (v1_point[1] + v2_point[1]) / 2.0;
+    result_coords[2] = (v1_point[2] + v2_point[2]) / 2.0;;
+
+    return result_coords;
+}
+
+} // flux
\ No newline at end of file
@@ -0,0 +1,194 @@
+#include "reorder.h"
+#include "tombstone.h"
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+namespace flux {
+
+namespace {
+
+unsigned long long
+spread_bits(unsigned long long x) {
+    /**
+     * Moves the low 20 bits of x to every third bit
+     */
+    x &= 0xfffffULL;
+    x = (x | (x << 32)) & 0x1f00000000ffffULL;
+    x = (x | (x << 16)) & 0x1f0000ff0000ffULL;
+    x = (x | (x << 8)) & 0x100f00f00f00f00fULL;
+    x = (x | (x << 4)) & 0x10c30c30c30c30c3ULL;
+    x = (x | (x << 2)) & 0x1249249249249249ULL;
+    return x;
+}
+
+// Key of dead elements, after every Morton code (those use 62 bits at most)
+const unsigned long long DEAD_KEY = std::numeric_limits<unsigned long long>::max();
+
+template<typename Element>
+void
+sort_by_key(
+    std::vector<std::unique_ptr<Element>>& elements,
+    const std::vector<unsigned long long>& keys
+) {
+    /**
+     * Stable sort of a container by keys (one per element, in container
+     * order). The (key, position) pairs are sorted, so comparisons never
+     * touch the elements, and the container is permuted once
+     */
+    int num_elements = elements.size();
+    std::vector<std::pair<unsigned long long, int>> order(num_elements);
+    for (int i = 0; i < num_elements; ++i) order[i] = std::make_pair(keys[i], i);
+    std::sort(order.begin(), order.end());
+
+    std::vector<std::unique_ptr<Element>> sorted(num_elements);
+    for (int i = 0; i < num_elements; ++i) sorted[i] = std::move(elements[order[i].second]);
+    elements.swap(sorted);
+}
+
+unsigned long long
+face_key(const HalfFace *face, const double *lower, const double *scale) {
+    double centroid[3] = {0.0, 0.0, 0.0};
+    const HalfEdge *halfedge = face->edge;
+    for (int i = 0; i < 3; ++i) {
+        for (int d = 0; d < 3; ++d) centroid[d] += halfedge->vertex->point[d] / 3.0;
+        halfedge = halfedge->next;
+    }
+    return morton_code(centroid, lower, scale);
+}
+
+template<typename Element>
+Element*
+moved(const std::unordered_map<Element*, Element*>& copies, Element *element) {
+    if (!element) return nullptr;
+    return copies.find(element)->second;
+}
+
+} // namespace
+
+unsigned long long
+morton_code(const double *point, const double *lower, const double *scale) {
+    /**
+     * Interleaves the 20-bit grid coordinates of point (x lowest). The code
+     * leaves the top 4 bits free
+     */
+    unsigned long long code = 0;
+    for (int d = 0; d < 3; ++d) {
+        double u = (point[d] - lower[d]) * scale[d];
+        u = std::min(std::max(u, 0.0), 1048575.0);
+        code |= spread_bits((unsigned long long) u) << d;
+    }
+    return code;
+}
+
+void
+reorder_mesh(
+    HalfEdgeMesh<Triangle>& halfmesh,
+    bool relocate,
+    std::vector<HalfVertex*>& tracked
+) {
+    /**
+     * Sorts (and optionally recreates) every element of halfmesh along a
+     * Morton curve over its bounding box
+     */
+    double lower[3], upper[3], scale[3];
+    for (int d = 0; d < 3; ++d) {
+        lower[d] = std::numeric_limits<double>::max();
+        upper[d] = -std::numeric_limits<double>::max();
+    }
+    for (auto& v : halfmesh.vertices()) {
+        if (is_dead(v.get())) continue;
+        for (int d = 0; d < 3; ++d) {
+            lower[d] = std::min(lower[d], v->point[d]);
+            upper[d] = std::max(upper[d], v->point[d]);
+        }
+    }
+    for (int d = 0; d < 3; ++d) {
+        scale[d] = (upper[d] > lower[d]) ? 1048575.0 / (upper[d] - lower[d]) : 0.0;
+    }
+
+    // Halfedge keys get two extra low bits to keep a face's halfedges in order
+    std::vector<unsigned long long> keys(halfmesh.vertices().size());
+    for (int i = 0; i < (int) keys.size(); ++i) {
+        const HalfVertex *vertex = halfmesh.vertices()[i].get();
+        keys[i] = is_dead(vertex) ? DEAD_KEY : morton_code(vertex->point.data(), lower, scale);
+    }
+    sort_by_key(halfmesh.vertices(), keys);
+
+    keys.resize(halfmesh.faces().size());
+    for (int i = 0; i < (int) keys.size(); ++i) {
+        const HalfFace *face = halfmesh.faces()[i].get();
+        keys[i] = is_dead(face) ? DEAD_KEY : face_key(face, lower, scale);
+    }
+    sort_by_key(halfmesh.faces(), keys);
+
+    keys.resize(halfmesh.edges().size());
+    for (int i = 0; i < (int) keys.size(); ++i) {
+        const HalfEdge *halfedge = halfmesh.edges()[i].get();
+        if (is_dead(halfedge)) {
+            keys[i] = DEAD_KEY;
+        } else if (halfedge->face) {
+            int corner = 0;
+            for (const HalfEdge *e = halfedge->face->edge; e != halfedge; e = e->next) corner++;
+            keys[i] = (face_key(halfedge->face, lower, scale) << 2) | corner;
+        } else {
+            // Boundary halfedges go right after the faces around their vertex
+            keys[i] = (morton_code(halfedge->vertex->point.data(), lower, scale) << 2) | 3;
+        }
+    }
+    sort_by_key(halfmesh.edges(), keys);
+    if (!relocate) return;
+
+    // Recreating every element in its new order
+    int num_vertices = halfmesh.vertices().size();
+    int num_edges = halfmesh.edges().size();
+    int num_faces = halfmesh.faces().size();
+    std::unordered_map<HalfVertex*, HalfVertex*> vertex_copies;
+    std::unordered_map<HalfEdge*, HalfEdge*> edge_copies;
+    std::unordered_map<HalfFace*, HalfFace*> face_copies;
+
+    for (int i = 0; i < num_vertices; ++i) {
+        HalfVertex *vertex = halfmesh.vertices()[i].get();
+        flux_assert(!is_dead(vertex));
+        HalfVertex *copy = halfmesh.create_vertex(3, vertex->point.data());
+        copy->index = vertex->index;
+        vertex_copies[vertex] = copy;
+    }
+    for (int i = 0; i < num_edges; ++i) {
+        HalfEdge *halfedge = halfmesh.edges()[i].get();
+        flux_assert(!is_dead(halfedge));
+        edge_copies[halfedge] = halfmesh.create_edge();
+    }
+    for (int i = 0; i < num_faces; ++i) {
+        HalfFace *face = halfmesh.faces()[i].get();
+        flux_assert(!is_dead(face));
+        face_copies[face] = halfmesh.create_face();
+    }
+
+    // Pointing the copies at each other
+    for (auto& entry : vertex_copies) {
+        entry.second->edge = moved(edge_copies, entry.first->edge);
+    }
+    for (auto& entry : edge_copies) {
+        HalfEdge *halfedge = entry.first;
+        HalfEdge *copy = entry.second;
+        copy->vertex = moved(vertex_copies, halfedge->vertex);
+        copy->twin = moved(edge_copies, halfedge->twin);
+        copy->next = moved(edge_copies, halfedge->next);
+        copy->prev = moved(edge_copies, halfedge->prev);
+        copy->face = moved(face_copies, halfedge->face);
+    }
+    for (auto& entry : face_copies) {
+        entry.second->edge = moved(edge_copies, entry.first->edge);
+    }
+    for (auto& vertex : tracked) {
+        vertex = moved(vertex_copies, vertex);
+    }
+
+    // The originals are the first part of each container
+    halfmesh.vertices().erase(halfmesh.vertices().begin(), halfmesh.vertices().begin() + num_vertices);
+    halfmesh.edges().erase(halfmesh.edges().begin(), halfmesh.edges().begin() + num_edges);
+    halfmesh.faces().erase(halfmesh.faces().begin(), halfmesh.faces().begin() + num_faces);
+}
+
+} // flux
@@ -0,0 +1,36 @@
+#ifndef FLUX_REMESHER3D_REORDER_H
+#define FLUX_REMESHER3D_REORDER_H
+
+#include "halfedges.h"
+#include "element.h"
+#include <vector>
+
+namespace flux {
+
+/**
+ * Spatial reordering of the HalfEdgeMesh containers.
+ *
+ * Vertices are sorted by the Morton code of their position within the
+ * bounding box, faces by the code of their centroid, and halfedges follow
+ * their face (boundary halfedges their vertex). Adjacency and SoAGeometry
+ * number elements in container order, so neighbours get nearby ids.
+ *
+ * HalfEdgeMesh allocates each element on its own, so sorting the containers
+ * does not move the elements themselves. With relocate, every element is
+ * recreated in the new order (where the copies land in memory is up to the
+ * allocator), all pointers are redirected to the copies and the originals
+ * are erased. Pointers held elsewhere become invalid then, except the ones in
+ * tracked, which are redirected too. The mesh must not contain dead elements
+ * when relocating.
+ */
+void reorder_mesh(
+    HalfEdgeMesh<Triangle>& halfmesh,
+    bool relocate,
+    std::vector<HalfVertex*>& tracked
+);
+
+unsigned long long morton_code(const double *point, const double *lower, const double *scale);
+
+} // flux
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef FLUX_REMESHER3D_REPORT_H
+#define FLUX_REMESHER3D_REPORT_H
+
+namespace flux {
+
+/**
+ * What one incremental_relaxation pass did, and the length/target ratio
+ * distribution of the edges it left behind (each edge counted once, 0 when
+ * turned off with set_ratio_report)
+ */
+struct IterationReport {
+    int num_splits;
+    int num_boundary_splits;
+    int num_collapses;
+    int num_flips;
+
+    double min_ratio;
+    double p10_ratio;
+    double median_ratio;
+    double p90_ratio;
+    double max_ratio;
+};
+
+} // flux
+
+#endif
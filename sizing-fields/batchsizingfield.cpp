@@ -0,0 +1,13 @@
+#include "batchsizingfield.h"
+
+namespace flux {
+
+void
+BatchSizingField::evaluate(const double *points, int num_points, double *sizes) const {
+    for (int i = 0; i < num_points; ++i) {
+        sizes[i] = (*this)(points + 3 * i);
+    }
+}
+
+
+}
@@ -0,0 +1,28 @@
+#ifndef FLUX_BATCH_SIZINGFIELD_H
+#define FLUX_BATCH_SIZINGFIELD_H
+#include "size.h"
+
+namespace flux {
+
+/**
+ * Sizing field that can be evaluated at many points in one call.
+ *
+ * points holds num_points xyz triples back to back and sizes receives one
+ * target length per point. The default evaluate() loops over operator(),
+ * fields that can do better (or that return the same length everywhere, see
+ * is_constant()) override it.
+ *
+ * Both operator() and evaluate() are called from several threads at once by
+ * a remesher running on more than one thread, and by remesh_batch workers
+ * sharing the field, so they must not modify the field. All fields here are
+ * read-only once constructed.
+ */
+class BatchSizingField : public SizingField<3> {
+public:
+
+virtual void evaluate(const double *points, int num_points, double *sizes) const;
+virtual bool is_constant() const { return false; }
+};
+} // flux
+
+#endif
@@ -1,13 +1,14 @@
 #include "edgelengthsizingfield.h"
+#include <algorithm>
 
 namespace flux {
 
 EdgelengthSizingField::EdgelengthSizingField(double edgelength) :
 _edgelength(edgelength) {  }
 
-double
-EdgelengthSizingField::operator()(const double *x) const {
-    return _edgelength;
+void
+EdgelengthSizingField::evaluate(const double *points, int num_points, double *sizes) const {
+    std::fill(sizes, sizes + num_points, _edgelength);
 }
 
 
@@ -1,19 +1,21 @@
 #ifndef FLUX_EDGELENGTH_SIZINGFIELD_H
 #define FLUX_EDGELENGTH_SIZINGFIELD_H
-#include "size.h"
+#include "batchsizingfield.h"
 
 namespace flux {
 
-class EdgelengthSizingField : public SizingField<3> {
+class EdgelengthSizingField final : public BatchSizingField {
 public:
 
 EdgelengthSizingField(double edgelength);
 
-double operator()(const double *x) const;
+double operator()(const double *x) const { return _edgelength; }
+void evaluate(const double *points, int num_points, double *sizes) const;
+bool is_constant() const { return true; }
 
 private:
 double _edgelength;
 };
 } // flux
 
-#endif
\ No newline at end of file
+#endif
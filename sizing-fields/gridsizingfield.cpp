@@ -0,0 +1,188 @@
+#include "gridsizingfield.h"
+#include "../parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+
+namespace flux {
+
+// Identifies files written by GridSizingField::save
+static const char GRID_MAGIC[8] = {'R', '3', 'D', 'G', 'R', 'I', 'D', '1'};
+
+GridSizingField::GridSizingField() {
+    for (int d = 0; d < 3; ++d) {
+        _lower[d] = 0.0;
+        _spacing[d] = 1.0;
+        _resolution[d] = 0;
+    }
+}
+
+GridSizingField::GridSizingField(
+    const SizingField<3>& field,
+    const double *lower,
+    const double *upper,
+    int nx, int ny, int nz,
+    int num_threads
+) {
+    _resolution[0] = nx;
+    _resolution[1] = ny;
+    _resolution[2] = nz;
+    sample(field, lower, upper, num_threads);
+}
+
+GridSizingField::GridSizingField(
+    const SizingField<3>& field,
+    HalfEdgeMesh<Triangle>& halfmesh,
+    int resolution,
+    int num_threads
+) :
+GridSizingField()
+{
+    /**
+     * Samples field over the bounding box of halfmesh, grown by one cell on
+     * every side so vertices pushed slightly outwards stay inside. The
+     * longest side of the box gets resolution cells, the others as many as
+     * keep the cells close to cubes. Every vertex counts, so halfmesh should
+     * hold no dead elements. A mesh without vertices (or with non-finite
+     * coordinates) leaves the grid empty, see nb_nodes()
+     */
+    if (halfmesh.vertices().empty()) return;
+
+    double lower[3], upper[3];
+    for (int d = 0; d < 3; ++d) {
+        lower[d] = std::numeric_limits<double>::max();
+        upper[d] = -std::numeric_limits<double>::max();
+    }
+    for (auto& v : halfmesh.vertices()) {
+        for (int d = 0; d < 3; ++d) {
+            lower[d] = std::min(lower[d], v->point[d]);
+            upper[d] = std::max(upper[d], v->point[d]);
+        }
+    }
+
+    double longest = 0.0;
+    for (int d = 0; d < 3; ++d) longest = std::max(longest, upper[d] - lower[d]);
+    if (!std::isfinite(longest)) return;
+    resolution = std::max(resolution, 1);
+    double cell = (longest > 0.0) ? longest / resolution : 1.0;
+
+    for (int d = 0; d < 3; ++d) {
+        lower[d] -= cell;
+        upper[d] += cell;
+        _resolution[d] = std::max(1, (int) std::ceil((upper[d] - lower[d]) / cell)) + 1;
+    }
+    sample(field, lower, upper, num_threads);
+}
+
+void
+GridSizingField::evaluate(const double *points, int num_points, double *sizes) const {
+    for (int i = 0; i < num_points; ++i) {
+        sizes[i] = interpolate(points + 3 * i);
+    }
+}
+
+bool
+GridSizingField::save(const std::string& filename) const {
+    /**
+     * Writes the box, resolution and node values in native byte order
+     *
+     * RETURNS: false if the file could not be written
+     */
+    std::ofstream file(filename, std::ios::binary);
+    if (!file) return false;
+
+    int32_t resolution[3] = {_resolution[0], _resolution[1], _resolution[2]};
+    file.write(GRID_MAGIC, sizeof(GRID_MAGIC));
+    file.write((const char*) resolution, sizeof(resolution));
+    file.write((const char*) _lower, sizeof(_lower));
+    file.write((const char*) _spacing, sizeof(_spacing));
+    file.write((const char*) _sizes.data(), _sizes.size() * sizeof(double));
+    return (bool) file;
+}
+
+bool
+GridSizingField::load(const std::string& filename) {
+    /**
+     * Reads a grid written by save(). The field is left unchanged on failure
+     *
+     * RETURNS: false if the file is missing, truncated or not a grid (or
+     * its spacing is not positive and finite)
+     */
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) return false;
+
+    char magic[sizeof(GRID_MAGIC)];
+    int32_t resolution[3];
+    double lower[3], spacing[3];
+    file.read(magic, sizeof(magic));
+    file.read((char*) resolution, sizeof(resolution));
+    file.read((char*) lower, sizeof(lower));
+    file.read((char*) spacing, sizeof(spacing));
+    if (!file || !std::equal(magic, magic + sizeof(magic), GRID_MAGIC)) return false;
+    if (resolution[0] < 1 || resolution[1] < 1 || resolution[2] < 1) return false;
+    for (int d = 0; d < 3; ++d) {
+        if (!std::isfinite(lower[d]) || !std::isfinite(spacing[d]) || spacing[d] <= 0.0) return false;
+    }
+
+    // A corrupt header must not size the node array beyond the file
+    std::streampos start = file.tellg();
+    file.seekg(0, std::ios::end);
+    size_t capacity = (size_t) (file.tellg() - start) / sizeof(double);
+    size_t num_nodes = 1;
+    for (int d = 0; d < 3; ++d) {
+        if ((size_t) resolution[d] > capacity / num_nodes) return false;
+        num_nodes *= resolution[d];
+    }
+    file.seekg(start);
+
+    std::vector<double> sizes(num_nodes);
+    file.read((char*) sizes.data(), sizes.size() * sizeof(double));
+    if (!file) return false;
+
+    for (int d = 0; d < 3; ++d) {
+        _resolution[d] = resolution[d];
+        _lower[d] = lower[d];
+        _spacing[d] = spacing[d];
+    }
+    _sizes.swap(sizes);
+    return true;
+}
+
+void
+GridSizingField::sample(
+    const SizingField<3>& field,
+    const double *lower,
+    const double *upper,
+    int num_threads
+) {
+    /**
+     * Evaluates field at every node, x fastest. Threads take contiguous ranges
+     * of z slices, so field must allow concurrent calls when num_threads > 1
+     */
+    for (int d = 0; d < 3; ++d) {
+        _resolution[d] = std::max(_resolution[d], 1);
+        _lower[d] = lower[d];
+        _spacing[d] = (_resolution[d] > 1) ? (upper[d] - lower[d]) / (_resolution[d] - 1) : 1.0;
+    }
+
+    int nx = _resolution[0], ny = _resolution[1];
+    _sizes.resize((size_t) nx * ny * _resolution[2]);
+
+    parallel_for(_resolution[2], num_threads, [&](int, int begin, int end) {
+        double x[3];
+        for (int k = begin; k < end; ++k) {
+            x[2] = _lower[2] + k * _spacing[2];
+            for (int j = 0; j < ny; ++j) {
+                x[1] = _lower[1] + j * _spacing[1];
+                for (int i = 0; i < nx; ++i) {
+                    x[0] = _lower[0] + i * _spacing[0];
+                    _sizes[((size_t) k * ny + j) * nx + i] = field(x);
+                }
+            }
+        }
+    });
+}
+
+}
@@ -0,0 +1,104 @@
+#ifndef FLUX_GRID_SIZINGFIELD_H
+#define FLUX_GRID_SIZINGFIELD_H
+#include "batchsizingfield.h"
+#include "halfedges.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace flux {
+
+/**
+ * Background grid sampled once from another sizing field.
+ *
+ * The field is evaluated at the nodes of a regular nx x ny x nz grid over a
+ * box, and queries are answered by trilinear interpolation of the eight
+ * surrounding nodes (points outside the box are clamped onto it). save() and
+ * load() write and read the sampled grid, so an expensive field only has to
+ * be sampled once for many jobs. The sampled field is called from num_threads
+ * threads at once, pass 1 for one that is not safe to call concurrently.
+ */
+class GridSizingField final : public BatchSizingField {
+public:
+
+GridSizingField();
+GridSizingField(
+    const SizingField<3>& field,
+    const double *lower,
+    const double *upper,
+    int nx, int ny, int nz,
+    int num_threads
+);
+GridSizingField(
+    const SizingField<3>& field,
+    HalfEdgeMesh<Triangle>& halfmesh,
+    int resolution,
+    int num_threads
+);
+
+double operator()(const double *x) const;
+void evaluate(const double *points, int num_points, double *sizes) const;
+
+bool save(const std::string& filename) const;
+bool load(const std::string& filename);
+
+// 0 until sampled or loaded, such a grid must not be queried
+int nb_nodes() const { return _sizes.size(); }
+
+private:
+double _lower[3];
+double _spacing[3];
+int _resolution[3];
+std::vector<double> _sizes;
+
+void sample(const SizingField<3>& field, const double *lower, const double *upper, int num_threads);
+double interpolate(const double *x) const;
+double node(int i, int j, int k) const;
+};
+
+// Defined here so remeshers over a GridSizingField inline their queries
+inline double
+GridSizingField::operator()(const double *x) const {
+    return interpolate(x);
+}
+
+inline double
+GridSizingField::interpolate(const double *x) const {
+    /**
+     * Trilinear interpolation of the eight nodes around x
+     */
+    flux_assert(!_sizes.empty());   // sampled or loaded grids only
+    int cell[3];
+    double t[3];
+    for (int d = 0; d < 3; ++d) {
+        double u = (x[d] - _lower[d]) / _spacing[d];
+        int last = _resolution[d] - 1;
+        u = std::min(std::max(u, 0.0), (double) last);
+
+        // The last node starts no cell, its points use the cell before it
+        cell[d] = std::min((int) u, std::max(last - 1, 0));
+        t[d] = (last > 0) ? u - cell[d] : 0.0;
+    }
+
+    int i1 = std::min(cell[0] + 1, _resolution[0] - 1);
+    int j1 = std::min(cell[1] + 1, _resolution[1] - 1);
+    int k1 = std::min(cell[2] + 1, _resolution[2] - 1);
+
+    double c00 = node(cell[0], cell[1], cell[2]) * (1 - t[0]) + node(i1, cell[1], cell[2]) * t[0];
+    double c10 = node(cell[0], j1, cell[2]) * (1 - t[0]) + node(i1, j1, cell[2]) * t[0];
+    double c01 = node(cell[0], cell[1], k1) * (1 - t[0]) + node(i1, cell[1], k1) * t[0];
+    double c11 = node(cell[0], j1, k1) * (1 - t[0]) + node(i1, j1, k1) * t[0];
+
+    double c0 = c00 * (1 - t[1]) + c10 * t[1];
+    double c1 = c01 * (1 - t[1]) + c11 * t[1];
+    return c0 * (1 - t[2]) + c1 * t[2];
+}
+
+inline double
+GridSizingField::node(int i, int j, int k) const {
+    return _sizes[((size_t) k * _resolution[1] + j) * _resolution[0] + i];
+}
+
+} // flux
+
+#endif
@@ -0,0 +1,58 @@
+#include "snapshot.h"
+#include "meshfile.h"
+#include <cstdio>
+
+namespace flux {
+
+bool
+save_obj(
+    const std::string& filename,
+    const double *points,
+    int num_vertices,
+    const int *triangles,
+    int num_triangles
+) {
+    /**
+     * Writes the mesh to filename as Wavefront OBJ (one-based vertex ids)
+     *
+     * RETURNS: false if the file could not be written
+     */
+    FILE *file = fopen(filename.c_str(), "w");
+    if (!file) return false;
+
+    for (int v = 0; v < num_vertices; ++v) {
+        const double *p = points + 3 * v;
+        fprintf(file, "v %.17g %.17g %.17g\n", p[0], p[1], p[2]);
+    }
+    for (int t = 0; t < num_triangles; ++t) {
+        const int *corners = triangles + 3 * t;
+        fprintf(file, "f %d %d %d\n", corners[0] + 1, corners[1] + 1, corners[2] + 1);
+    }
+
+    bool succeeded = !ferror(file);
+    return (fclose(file) == 0) && succeeded;
+}
+
+static bool
+ends_with(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() &&
+        text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool
+save_snapshot(const std::string& filename, const Snapshot& snapshot) {
+    /**
+     * Writes snapshot to filename, as Wavefront OBJ if the name ends in
+     * ".obj" and as a binary mesh file (see meshfile.h) otherwise
+     *
+     * RETURNS: false if the file could not be written
+     */
+    int nv = snapshot.points.size() / 3;
+    int nt = snapshot.triangles.size() / 3;
+    if (ends_with(filename, ".obj")) {
+        return save_obj(filename, snapshot.points.data(), nv, snapshot.triangles.data(), nt);
+    }
+    return save_mesh(filename, snapshot.points.data(), nv, snapshot.triangles.data(), nt);
+}
+
+} // flux
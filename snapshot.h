@@ -0,0 +1,39 @@
+#ifndef FLUX_REMESHER3D_SNAPSHOT_H
+#define FLUX_REMESHER3D_SNAPSHOT_H
+
+#include "writer.h"
+#include <string>
+#include <vector>
+
+namespace flux {
+
+/**
+ * Copy of the mesh after one remeshing or relaxation pass, as flat arrays.
+ */
+struct Snapshot {
+    std::vector<double> points;         // xyz per vertex
+    std::vector<int> triangles;         // three vertex ids per triangle
+};
+
+bool save_obj(
+    const std::string& filename,
+    const double *points,
+    int num_vertices,
+    const int *triangles,
+    int num_triangles
+);
+
+bool save_snapshot(const std::string& filename, const Snapshot& snapshot);
+
+/**
+ * Writes snapshots on a background thread with save_snapshot().
+ */
+class SnapshotWriter : public BackgroundWriter<Snapshot> {
+public:
+
+SnapshotWriter() : BackgroundWriter<Snapshot>(save_snapshot) {  }
+};
+
+} // flux
+
+#endif
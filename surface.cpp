@@ -0,0 +1,253 @@
+#include "surface.h"
+#include "tombstone.h"
+#include <algorithm>
+#include <limits>
+
+namespace flux {
+
+ReferenceSurface::ReferenceSurface()
+{  }
+
+void
+ReferenceSurface::snapshot(HalfEdgeMesh<Triangle>& halfmesh) {
+    /**
+     * Copies the corners of every live face of halfmesh. Drops any BVH built
+     * for an earlier snapshot
+     */
+    _triangles.clear();
+    _nodes.clear();
+    _order.clear();
+
+    for (auto& f : halfmesh.faces()) {
+        HalfFace *face = f.get();
+        if (is_dead(face)) continue;
+
+        HalfEdge *halfedge = face->edge;
+        for (int i = 0; i < 3; ++i) {
+            for (int d = 0; d < 3; ++d) {
+                _triangles.push_back(halfedge->vertex->point[d]);
+            }
+            halfedge = halfedge->next;
+        }
+    }
+}
+
+void
+ReferenceSurface::snapshot(const std::vector<double>& corners) {
+    /**
+     * Takes the triangles from corners (nine coordinates each, as returned by
+     * corners()). Drops any BVH built for an earlier snapshot
+     */
+    _triangles = corners;
+    _nodes.clear();
+    _order.clear();
+}
+
+void
+ReferenceSurface::build() {
+    /**
+     * Builds the BVH over the snapshot
+     */
+    int num_triangles = nb_triangles();
+    _nodes.clear();
+    _order.resize(num_triangles);
+    if (!num_triangles) return;
+
+    std::vector<double> centroids(3 * num_triangles);
+    for (int t = 0; t < num_triangles; ++t) {
+        _order[t] = t;
+        const double *corners = &_triangles[9 * t];
+        for (int d = 0; d < 3; ++d) {
+            centroids[3 * t + d] = (corners[d] + corners[3 + d] + corners[6 + d]) / 3.0;
+        }
+    }
+
+    // Roughly the number of nodes of a tree with full leaves
+    _nodes.reserve(2 * num_triangles / LEAF_SIZE + 1);
+    _nodes.emplace_back();
+    build_node(0, 0, num_triangles, centroids);
+}
+
+vec3d
+ReferenceSurface::closest_point(const vec3d& point) const {
+    /**
+     * Closest point to point on the snapshot (point itself if it is empty)
+     */
+    vec3d result = point;
+    if (_nodes.empty()) return result;
+
+    double best = std::numeric_limits<double>::max();
+    double closest[3];
+    int stack[64];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top) {
+        const Node& node = _nodes[stack[--top]];
+        if (box_distance(node, point.data()) >= best) continue;
+
+        if (node.count) {
+            for (int i = node.first; i < node.first + node.count; ++i) {
+                double distance = closest_on_triangle(_order[i], point.data(), closest);
+                if (distance >= best) continue;
+                best = distance;
+                for (int d = 0; d < 3; ++d) result[d] = closest[d];
+            }
+            continue;
+        }
+
+        // Pushing the farther child first so the nearer one is searched first
+        double left = box_distance(_nodes[node.first], point.data());
+        double right = box_distance(_nodes[node.first + 1], point.data());
+        if (left < right) {
+            stack[top++] = node.first + 1;
+            stack[top++] = node.first;
+        } else {
+            stack[top++] = node.first;
+            stack[top++] = node.first + 1;
+        }
+    }
+    return result;
+}
+
+void
+ReferenceSurface::build_node(
+    int index,
+    int begin,
+    int end,
+    const std::vector<double>& centroids
+) {
+    /**
+     * Fills node index with the triangles _order[begin, end), splitting it in
+     * two children if there are more than LEAF_SIZE
+     */
+    double lower[3], upper[3], centroid_lower[3], centroid_upper[3];
+    for (int d = 0; d < 3; ++d) {
+        lower[d] = centroid_lower[d] = std::numeric_limits<double>::max();
+        upper[d] = centroid_upper[d] = -std::numeric_limits<double>::max();
+    }
+
+    for (int i = begin; i < end; ++i) {
+        const double *corners = &_triangles[9 * _order[i]];
+        const double *centroid = &centroids[3 * _order[i]];
+        for (int d = 0; d < 3; ++d) {
+            for (int c = 0; c < 3; ++c) {
+                lower[d] = std::min(lower[d], corners[3 * c + d]);
+                upper[d] = std::max(upper[d], corners[3 * c + d]);
+            }
+            centroid_lower[d] = std::min(centroid_lower[d], centroid[d]);
+            centroid_upper[d] = std::max(centroid_upper[d], centroid[d]);
+        }
+    }
+    std::copy(lower, lower + 3, _nodes[index].lower);
+    std::copy(upper, upper + 3, _nodes[index].upper);
+
+    if (end - begin <= LEAF_SIZE) {
+        _nodes[index].first = begin;
+        _nodes[index].count = end - begin;
+        return;
+    }
+
+    // Median split along the longest axis of the centroids
+    int axis = 0;
+    for (int d = 1; d < 3; ++d) {
+        if (centroid_upper[d] - centroid_lower[d] > centroid_upper[axis] - centroid_lower[axis]) {
+            axis = d;
+        }
+    }
+    int middle = (begin + end) / 2;
+    std::nth_element(_order.begin() + begin, _order.begin() + middle, _order.begin() + end,
+        [&](int a, int b) { return centroids[3 * a + axis] < centroids[3 * b + axis]; });
+
+    // Children are stored next to each other
+    int left = _nodes.size();
+    _nodes[index].first = left;
+    _nodes[index].count = 0;
+    _nodes.emplace_back();
+    _nodes.emplace_back();
+
+    build_node(left, begin, middle, centroids);
+    build_node(left + 1, middle, end, centroids);
+}
+
+double
+ReferenceSurface::box_distance(const Node& node, const double *point) const {
+    /**
+     * Squared distance from point to the box of node (0 inside)
+     */
+    double distance = 0.0;
+    for (int d = 0; d < 3; ++d) {
+        double outside = std::max(std::max(node.lower[d] - point[d], point[d] - node.upper[d]), 0.0);
+        distance += outside * outside;
+    }
+    return distance;
+}
+
+double
+ReferenceSurface::closest_on_triangle(int t, const double *point, double *closest) const {
+    /**
+     * Closest point to point on triangle t, found by locating point in the
+     * Voronoi regions of the corners, edges and face of the triangle (Ericson,
+     * Real-Time Collision Detection, 5.1.5)
+     *
+     * RETURNS: squared distance between point and closest
+     */
+    const double *a = &_triangles[9 * t];
+    const double *b = a + 3;
+    const double *c = a + 6;
+
+    double ab[3], ac[3], ap[3];
+    for (int d = 0; d < 3; ++d) {
+        ab[d] = b[d] - a[d];
+        ac[d] = c[d] - a[d];
+        ap[d] = point[d] - a[d];
+    }
+
+    double u = 0.0, v = 0.0;   // closest = a + u * ab + v * ac
+    double d1 = ab[0] * ap[0] + ab[1] * ap[1] + ab[2] * ap[2];
+    double d2 = ac[0] * ap[0] + ac[1] * ap[1] + ac[2] * ap[2];
+
+    if (d1 <= 0.0 && d2 <= 0.0) {
+        // Corner a
+    } else {
+        double bp[3], cp[3];
+        for (int d = 0; d < 3; ++d) {
+            bp[d] = point[d] - b[d];
+            cp[d] = point[d] - c[d];
+        }
+        double d3 = ab[0] * bp[0] + ab[1] * bp[1] + ab[2] * bp[2];
+        double d4 = ac[0] * bp[0] + ac[1] * bp[1] + ac[2] * bp[2];
+        double d5 = ab[0] * cp[0] + ab[1] * cp[1] + ab[2] * cp[2];
+        double d6 = ac[0] * cp[0] + ac[1] * cp[1] + ac[2] * cp[2];
+
+        double vc = d1 * d4 - d3 * d2;
+        double vb = d5 * d2 - d1 * d6;
+        double va = d3 * d6 - d5 * d4;
+
+        if (d3 >= 0.0 && d4 <= d3) {
+            u = 1.0;                                    // corner b
+        } else if (d6 >= 0.0 && d5 <= d6) {
+            v = 1.0;                                    // corner c
+        } else if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0) {
+            u = d1 / (d1 - d3);                         // edge ab
+        } else if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0) {
+            v = d2 / (d2 - d6);                         // edge ac
+        } else if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0) {
+            v = (d4 - d3) / ((d4 - d3) + (d5 - d6));    // edge bc
+            u = 1.0 - v;
+        } else {
+            double denominator = 1.0 / (va + vb + vc);  // inside the face
+            u = vb * denominator;
+            v = vc * denominator;
+        }
+    }
+
+    double distance = 0.0;
+    for (int d = 0; d < 3; ++d) {
+        closest[d] = a[d] + u * ab[d] + v * ac[d];
+        distance += (point[d] - closest[d]) * (point[d] - closest[d]);
+    }
+    return distance;
+}
+
+} // flux
@@ -0,0 +1,58 @@
+#ifndef FLUX_REMESHER3D_SURFACE_H
+#define FLUX_REMESHER3D_SURFACE_H
+
+#include "halfedges.h"
+#include "element.h"
+#include "vec.hpp"
+#include <vector>
+
+namespace flux {
+
+/**
+ * Frozen copy of the triangles of a mesh with a bounding volume hierarchy
+ * for closest-point queries.
+ *
+ * snapshot() copies the coordinates, so later changes to the mesh do not
+ * affect the surface. The BVH is built over triangle centroids by median
+ * splits along the longest axis, and closest_point() descends into the
+ * nearer child first, skipping every box farther away than the best
+ * triangle found so far. Queries only read, so any number of threads can
+ * run them at once.
+ */
+class ReferenceSurface {
+public:
+
+ReferenceSurface();
+
+void snapshot(HalfEdgeMesh<Triangle>& halfmesh);
+void snapshot(const std::vector<double>& corners);
+void build();
+vec3d closest_point(const vec3d& point) const;
+
+int nb_triangles() const { return _triangles.size() / 9; }
+const std::vector<double>& corners() const { return _triangles; }
+bool is_built() const { return !_nodes.empty(); }
+
+private:
+struct Node {
+    double lower[3], upper[3];
+    int first;      // first child (inner node) or first slot in _order (leaf)
+    int count;      // number of triangles, 0 for inner nodes
+};
+
+// Triangle corners, 9 coordinates per triangle
+std::vector<double> _triangles;
+std::vector<int> _order;
+std::vector<Node> _nodes;
+
+// Triangles per leaf
+static const int LEAF_SIZE = 4;
+
+void build_node(int index, int begin, int end, const std::vector<double>& centroids);
+double box_distance(const Node& node, const double *point) const;
+double closest_on_triangle(int t, const double *point, double *closest) const;
+};
+
+} // flux
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef FLUX_REMESHER3D_TOMBSTONE_H
+#define FLUX_REMESHER3D_TOMBSTONE_H
+
+#include "halfedges.h"
+#include "element.h"
+#include <algorithm>
+#include <limits>
+
+namespace flux {
+
+/**
+ * Tombstones for mesh elements whose deletion is deferred.
+ *
+ * A dead element stays in the HalfEdgeMesh containers, disconnected, until
+ * erase_dead() removes all of them in one pass per container. Live elements
+ * never have a null vertex (halfedges) or null edge (faces), and boundary
+ * vertices use an index <= -1 that is at least -2 - (number of vertices)
+ * (see Adjacency), so the markers below cannot collide with them.
+ */
+const int DEAD_VERTEX_INDEX = std::numeric_limits<int>::min();
+
+inline void
+kill(HalfVertex *vertex) {
+    vertex->edge = nullptr;
+    vertex->index = DEAD_VERTEX_INDEX;
+}
+
+inline void
+kill(HalfEdge *halfedge) {
+    halfedge->vertex = nullptr;
+    halfedge->twin = nullptr;
+    halfedge->next = nullptr;
+    halfedge->face = nullptr;
+}
+
+inline void
+kill(HalfFace *face) {
+    face->edge = nullptr;
+}
+
+inline bool is_dead(const HalfVertex *vertex) { return vertex->index == DEAD_VERTEX_INDEX; }
+inline bool is_dead(const HalfEdge *halfedge) { return halfedge->vertex == nullptr; }
+inline bool is_dead(const HalfFace *face) { return face->edge == nullptr; }
+
+template<typename Container>
+int
+erase_dead(Container& elements) {
+    /**
+     * Erases every dead element of a HalfEdgeMesh container in a single pass
+     *
+     * RETURNS: number of erased elements
+     */
+    typedef typename Container::value_type Element;
+    auto last = std::remove_if(elements.begin(), elements.end(), [](const Element& element) {
+        return is_dead(element.get());
+    });
+    int num_erased = std::distance(last, elements.end());
+    elements.erase(last, elements.end());
+    return num_erased;
+}
+
+inline int
+erase_dead(HalfEdgeMesh<Triangle>& halfmesh) {
+    /**
+     * Erases every dead vertex, halfedge and face of halfmesh
+     */
+    return erase_dead(halfmesh.faces()) + erase_dead(halfmesh.edges())
+        + erase_dead(halfmesh.vertices());
+}
+
+} // flux
+
+#endif
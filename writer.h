@@ -0,0 +1,69 @@
+#ifndef FLUX_REMESHER3D_WRITER_H
+#define FLUX_REMESHER3D_WRITER_H
+
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace flux {
+
+/**
+ * Writes payloads to disk on a background thread, one at a time, with save.
+ * write() swaps the caller's payload with the one written last, so the two
+ * act as a double buffer and neither is reallocated once grown. It only
+ * waits if the previous write is still running. Failed writes are counted
+ * until the next wait(), so a later success cannot hide them.
+ */
+template<typename Payload>
+class BackgroundWriter {
+public:
+
+typedef bool (*SaveFunction)(const std::string& filename, const Payload& payload);
+
+BackgroundWriter(SaveFunction save) :
+_save(save),
+_num_failed(0)
+{  }
+
+~BackgroundWriter() {
+    wait();
+}
+
+BackgroundWriter(const BackgroundWriter&) = delete;
+BackgroundWriter& operator=(const BackgroundWriter&) = delete;
+
+void write(const std::string& filename, Payload& payload) {
+    /**
+     * Starts writing payload to filename in the background. The contents of
+     * payload are taken over (it is left with the buffers of the previous
+     * write, ready to be refilled)
+     */
+    if (_thread.joinable()) _thread.join();
+    std::swap(_payload, payload);
+    _thread = std::thread([this, filename]() {
+        if (!_save(filename, _payload)) ++_num_failed;
+    });
+}
+
+bool wait() {
+    /**
+     * Waits for the write in progress, if any
+     *
+     * RETURNS: false if any write since the last wait() failed
+     */
+    if (_thread.joinable()) _thread.join();
+    bool succeeded = (_num_failed == 0);
+    _num_failed = 0;
+    return succeeded;
+}
+
+private:
+SaveFunction _save;
+std::thread _thread;
+Payload _payload;
+int _num_failed;
+};
+
+} // flux
+
+#endif